@@ -0,0 +1,65 @@
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+
+// Recorded real-world transcripts: a verbose cargo build (line-oriented
+// output with colors and progress redraws), a weechat session and a crawl
+// session (both full-screen curses redraws, reused from the vt100 test
+// data).
+fn corpus() -> Vec<(&'static str, Vec<u8>)> {
+  let crawl = (1..=20)
+    .flat_map(|i| {
+      std::fs::read(format!("vendor/vt100/tests/data/crawl/crawl{}", i))
+        .unwrap()
+    })
+    .collect();
+  vec![
+    (
+      "cargo-build",
+      std::fs::read("benches/data/cargo-build.typescript").unwrap(),
+    ),
+    (
+      "weechat",
+      std::fs::read("vendor/vt100/tests/data/weechat.typescript").unwrap(),
+    ),
+    ("crawl", crawl),
+  ]
+}
+
+fn process(c: &mut Criterion) {
+  let mut group = c.benchmark_group("process");
+  for (name, bytes) in corpus() {
+    group.throughput(Throughput::Bytes(bytes.len() as u64));
+    group.bench_function(name, |b| {
+      b.iter(|| {
+        let mut parser = vt100::Parser::new(40, 120, 1000);
+        parser.process(&bytes);
+        parser
+      })
+    });
+  }
+  group.finish();
+}
+
+// Plain lines pushed past the bottom of the screen, so every line goes
+// through the scroll path and into scrollback.
+fn scroll(c: &mut Criterion) {
+  let lines: Vec<u8> = (0..10_000)
+    .flat_map(|i| {
+      format!("{:6} lines of output filling up the scrollback\r\n", i)
+        .into_bytes()
+    })
+    .collect();
+
+  let mut group = c.benchmark_group("scroll");
+  group.throughput(Throughput::Bytes(lines.len() as u64));
+  group.bench_function("10k-lines", |b| {
+    b.iter(|| {
+      let mut parser = vt100::Parser::new(40, 120, 100_000);
+      parser.process(&lines);
+      parser
+    })
+  });
+  group.finish();
+}
+
+criterion_group!(benches, process, scroll);
+criterion_main!(benches);
@@ -0,0 +1,26 @@
+use criterion::{criterion_group, criterion_main, Criterion};
+use mprocs::proc::CopyMode;
+use mprocs::ui_term::UiTerm;
+use tui::{buffer::Buffer, layout::Rect, widgets::Widget};
+
+// Draws a populated screen through the UiTerm widget into a tui buffer,
+// which is what happens on every frame for the focused process.
+fn render(c: &mut Criterion) {
+  let mut parser = vt100::Parser::new(40, 120, 0);
+  parser.process(
+    &std::fs::read("vendor/vt100/tests/data/weechat.typescript").unwrap(),
+  );
+  let screen = parser.screen();
+  let area = Rect::new(0, 0, 120, 40);
+
+  c.bench_function("render/ui_term", |b| {
+    b.iter(|| {
+      let mut buf = Buffer::empty(area);
+      UiTerm::new(screen, &CopyMode::None(None), None).render(area, &mut buf);
+      buf
+    })
+  });
+}
+
+criterion_group!(benches, render);
+criterion_main!(benches);
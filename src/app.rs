@@ -1,4 +1,10 @@
-use std::{io, rc::Rc};
+use std::{
+  collections::HashMap,
+  io,
+  rc::Rc,
+  sync::{Arc, Mutex},
+  time::{Duration, Instant},
+};
 
 use crossterm::{
   event::{
@@ -12,34 +18,73 @@ use crossterm::{
   },
 };
 use futures::{future::FutureExt, select, StreamExt};
-use tokio::{
-  io::AsyncReadExt,
-  sync::mpsc::{UnboundedReceiver, UnboundedSender},
-};
+use tokio::sync::mpsc::{UnboundedReceiver, UnboundedSender};
 use tui::{
-  backend::CrosstermBackend,
   layout::{Constraint, Direction, Layout, Margin, Rect},
   Terminal,
 };
 use tui_input::Input;
 
 use crate::{
-  config::{CmdConfig, Config, ProcConfig, ServerConfig},
+  config::{
+    AutostartConfig, CmdConfig, Config, ProcConfig, ServerConfig,
+    DEFAULT_SCROLLBACK,
+  },
+  ctl::read_frame,
+  dirty::DirtyProcs,
   event::{AppEvent, CopyMove},
   key::Key,
   keymap::Keymap,
   proc::{CopyMode, Pos, Proc, ProcState, ProcUpdate, StopSignal},
+  reaper::Reaper,
+  scheduler::ParseScheduler,
+  session,
   state::{Modal, Scope, State},
+  stats::{self, StatsState},
+  term_buf::{Backend, ClientSink, TermOut},
   ui_add_proc::render_add_proc,
   ui_confirm_quit::render_confirm_quit,
+  ui_copy_search::render_copy_search,
   ui_keymap::render_keymap,
   ui_procs::{procs_check_hit, procs_get_clicked_index, render_procs},
   ui_remove_proc::render_remove_proc,
+  ui_stats::render_stats,
   ui_term::{render_term, term_check_hit},
   ui_zoom_tip::render_zoom_tip,
 };
 
-type Term = Terminal<CrosstermBackend<io::Stdout>>;
+type Term = Terminal<Backend>;
+
+enum Listener {
+  Tcp(tokio::net::TcpListener),
+  #[cfg(unix)]
+  Unix(tokio::net::UnixListener),
+}
+
+/// Streams from either listener, split so that an attaching client can
+/// have frames written back while commands are still being read.
+type RemoteSocket = (
+  Box<dyn tokio::io::AsyncRead + Send + Unpin>,
+  Box<dyn tokio::io::AsyncWrite + Send + Unpin>,
+);
+
+impl Listener {
+  async fn accept(&self) -> io::Result<RemoteSocket> {
+    match self {
+      Listener::Tcp(listener) => {
+        let (socket, _) = listener.accept().await?;
+        let (read, write) = socket.into_split();
+        Ok((Box::new(read), Box::new(write)))
+      }
+      #[cfg(unix)]
+      Listener::Unix(listener) => {
+        let (socket, _) = listener.accept().await?;
+        let (read, write) = socket.into_split();
+        Ok((Box::new(read), Box::new(write)))
+      }
+    }
+  }
+}
 
 enum LoopAction {
   Render,
@@ -47,6 +92,29 @@ enum LoopAction {
   ForceQuit,
 }
 
+impl LoopAction {
+  /// The higher priority action wins: ForceQuit > Render > Skip.
+  fn merge(self, other: Self) -> Self {
+    match (self, other) {
+      (LoopAction::ForceQuit, _) | (_, LoopAction::ForceQuit) => {
+        LoopAction::ForceQuit
+      }
+      (LoopAction::Render, _) | (_, LoopAction::Render) => LoopAction::Render,
+      (LoopAction::Skip, LoopAction::Skip) => LoopAction::Skip,
+    }
+  }
+}
+
+/// How long resize events must stay quiet before the settled size is
+/// applied. Dragging a terminal corner fires dozens of events; reflowing
+/// every grid for each one freezes the ui.
+const RESIZE_DEBOUNCE: Duration = Duration::from_millis(150);
+
+/// Cadence of redraws driven purely by background proc activity (the
+/// rate column in the proc list). Their actual output isn't visible, so
+/// repainting at the full frame rate would only burn cpu.
+const ACTIVITY_REFRESH: Duration = Duration::from_secs(1);
+
 pub struct App {
   config: Config,
   keymap: Rc<Keymap>,
@@ -56,27 +124,56 @@ pub struct App {
   upd_tx: UnboundedSender<(usize, ProcUpdate)>,
   ev_rx: UnboundedReceiver<AppEvent>,
   ev_tx: UnboundedSender<AppEvent>,
+  dirty: Arc<DirtyProcs>,
+  reaper: Arc<Reaper>,
+  scheduler: Arc<ParseScheduler>,
+  /// Size from the latest `Event::Resize`, waiting out the debounce.
+  pending_resize: Option<(u16, u16)>,
+  /// When to apply `pending_resize`; pushed back by every new event.
+  resize_at: Option<Instant>,
+  /// Pending slow redraw for background proc activity.
+  refresh_at: Option<Instant>,
+  /// Daemon mode: no local terminal. Frames are only drawn while a
+  /// client is attached, and go to the client instead of stdout.
+  headless: bool,
+  client: ClientSink,
+  client_size: Arc<Mutex<(u16, u16)>>,
 }
 
 impl App {
   pub fn from_config_file(
     config: Config,
     keymap: Keymap,
+    headless: bool,
   ) -> anyhow::Result<Self> {
-    let backend = CrosstermBackend::new(io::stdout());
+    let client: ClientSink = Arc::new(Mutex::new(None));
+    // Procs spawned before the first client attaches get this size.
+    let client_size = Arc::new(Mutex::new((80u16, 24u16)));
+    let backend = if headless {
+      Backend::client(client.clone(), client_size.clone())
+    } else {
+      Backend::stdout()
+    };
     let terminal = Terminal::new(backend)?;
 
     let (upd_tx, upd_rx) =
       tokio::sync::mpsc::unbounded_channel::<(usize, ProcUpdate)>();
     let (ev_tx, ev_rx) = tokio::sync::mpsc::unbounded_channel::<AppEvent>();
+    let dirty = Arc::new(DirtyProcs::new());
+    let reaper = Arc::new(Reaper::new());
+    let scheduler = Arc::new(ParseScheduler::new());
 
     let state = State {
       scope: Scope::Procs,
       procs: Vec::new(),
+      proc_index: HashMap::new(),
       selected: 0,
+      procs_scroll: 0,
 
       modal: None,
 
+      stats: StatsState::new(),
+
       quitting: false,
     };
 
@@ -90,31 +187,55 @@ impl App {
 
       ev_rx,
       ev_tx,
+      dirty,
+      reaper,
+      scheduler,
+      pending_resize: None,
+      resize_at: None,
+      refresh_at: None,
+      headless,
+      client,
+      client_size,
     };
     Ok(app)
   }
 
   pub async fn run(mut self) -> anyhow::Result<()> {
-    enable_raw_mode()?;
-    execute!(io::stdout(), EnterAlternateScreen)?;
-    self.terminal.clear()?;
-    execute!(io::stdout(), EnableMouseCapture)?;
+    if !self.headless {
+      enable_raw_mode()?;
+      execute!(io::stdout(), EnterAlternateScreen)?;
+      self.terminal.clear()?;
+      execute!(io::stdout(), EnableMouseCapture)?;
+    }
 
     let (exit_trigger, exit_listener) = triggered::trigger();
 
     let server_thread = if let Some(ref server_addr) = self.config.server {
       let server = match server_addr {
-        ServerConfig::Tcp(addr) => tokio::net::TcpListener::bind(addr).await?,
+        ServerConfig::Tcp(addr) => {
+          Listener::Tcp(tokio::net::TcpListener::bind(addr).await?)
+        }
+        #[cfg(unix)]
+        ServerConfig::Unix(path) => {
+          // A leftover socket file from a previous run would fail the bind.
+          let _ = std::fs::remove_file(path);
+          Listener::Unix(tokio::net::UnixListener::bind(path)?)
+        }
+        #[cfg(not(unix))]
+        ServerConfig::Unix(_) => {
+          anyhow::bail!("Unix sockets are not supported on this platform.")
+        }
       };
 
       let ev_tx = self.ev_tx.clone();
+      let client_slot = self.client.clone();
       let server_thread = tokio::spawn(async move {
         loop {
           let on_exit = exit_listener.clone();
-          let mut socket: tokio::net::TcpStream = select! {
+          let (mut reader, writer) = select! {
             _ = on_exit.fuse() => break,
             client = server.accept().fuse() => {
-              if let Ok((socket, _)) = client {
+              if let Ok(socket) = client {
                 socket
               } else {
                 break;
@@ -123,20 +244,58 @@ impl App {
           };
 
           let ctl_tx = ev_tx.clone();
+          let client_slot = client_slot.clone();
           let on_exit = exit_listener.clone();
           tokio::spawn(async move {
-            let mut buf: Vec<u8> = Vec::with_capacity(32);
-            let () = select! {
-              _ = on_exit.fuse() => return,
-              count = socket.read_to_end(&mut buf).fuse() => {
-                if count.is_err() {
-                  return;
+            let mut writer = Some(writer);
+            // The frame sender installed if this connection attached, so
+            // that the slot is only cleared by the connection owning it.
+            let mut attached: Option<UnboundedSender<Vec<u8>>> = None;
+            // Connections are persistent: keep reading command frames
+            // until the client hangs up.
+            loop {
+              let msg = select! {
+                _ = on_exit.clone().fuse() => break,
+                msg = read_frame(&mut reader).fuse() => msg,
+              };
+              match msg {
+                Ok(Some(msg)) => {
+                  if let AppEvent::Attach { .. } = &msg {
+                    if let Some(mut writer) = writer.take() {
+                      let (tx, mut rx) =
+                        tokio::sync::mpsc::unbounded_channel::<Vec<u8>>();
+                      tokio::spawn(async move {
+                        use tokio::io::AsyncWriteExt;
+                        while let Some(bytes) = rx.recv().await {
+                          if writer.write_all(&bytes).await.is_err() {
+                            break;
+                          }
+                          let _result = writer.flush().await;
+                        }
+                      });
+                      // A newer attach wins: replacing the sender shuts
+                      // down the previous client's writer task.
+                      *client_slot.lock().unwrap() = Some(tx.clone());
+                      attached = Some(tx);
+                    }
+                  }
+                  if ctl_tx.send(msg).is_err() {
+                    break;
+                  }
+                }
+                Ok(None) => break,
+                Err(err) => {
+                  log::warn!("Remote command error: {}", err);
+                  break;
                 }
               }
-            };
-            let msg: AppEvent = serde_yaml::from_slice(buf.as_slice()).unwrap();
-            // log::info!("Received remote command: {:?}", msg);
-            ctl_tx.send(msg).unwrap();
+            }
+            if let Some(attached) = attached {
+              let mut slot = client_slot.lock().unwrap();
+              if matches!(&*slot, Some(tx) if tx.same_channel(&attached)) {
+                *slot = None;
+              }
+            }
           });
         }
       });
@@ -145,22 +304,41 @@ impl App {
       None
     };
 
+    #[cfg(unix)]
+    let unix_sock = match &self.config.server {
+      Some(ServerConfig::Unix(path)) => Some(path.clone()),
+      _ => None,
+    };
+
+    let headless = self.headless;
     let result = self.main_loop().await;
 
     exit_trigger.trigger();
     if let Some(server_thread) = server_thread {
       let _ = server_thread.await;
     }
+    #[cfg(unix)]
+    if let Some(path) = unix_sock {
+      let _ = std::fs::remove_file(path);
+    }
 
-    execute!(io::stdout(), DisableMouseCapture)?;
-    execute!(io::stdout(), LeaveAlternateScreen)?;
-    disable_raw_mode()?;
+    if !headless {
+      execute!(io::stdout(), DisableMouseCapture)?;
+      execute!(io::stdout(), LeaveAlternateScreen)?;
+      disable_raw_mode()?;
+    }
 
     result
   }
 
   async fn main_loop(mut self) -> anyhow::Result<()> {
-    let mut input = EventStream::new();
+    // A daemon has no terminal on stdin to read events from; keys arrive
+    // from the attached client as `Keypress` frames instead.
+    let mut input = if self.headless {
+      None
+    } else {
+      Some(EventStream::new())
+    };
 
     let mut last_term_size = {
       let area = self.get_layout().term_area();
@@ -168,13 +346,29 @@ impl App {
       (area.width, area.height)
     };
 
-    let mut render_needed = true;
+    let frame_interval =
+      Duration::from_secs(1) / self.config.render_fps.max(1) as u32;
+    let mut last_render = Instant::now() - frame_interval;
+    // When set, a repaint is pending and will happen at the given time at the
+    // earliest. Render requests arriving before that are coalesced into a
+    // single draw, so repaints are capped at `render_fps` no matter how many
+    // procs are spewing output.
+    let mut render_at: Option<Instant> = if self.headless {
+      // Nothing to draw to until a client attaches.
+      None
+    } else {
+      Some(Instant::now())
+    };
     loop {
+      let render_needed = matches!(render_at, Some(at) if at <= Instant::now());
       if render_needed {
+        let draw_started = Instant::now();
+        crate::prof_span!("draw");
         self.terminal.draw(|f| {
           let layout = AppLayout::new(
             f.size(),
             self.state.scope.is_zoomed(),
+            self.state.stats.height(self.state.procs.len()),
             &self.config,
           );
 
@@ -183,14 +377,25 @@ impl App {
             let term_size = (term_area.width, term_area.height);
             if last_term_size != term_size {
               last_term_size = term_size;
-              for proc in &mut self.state.procs {
-                proc.resize(term_area);
+              let selected = self.state.selected;
+              for (i, proc) in self.state.procs.iter_mut().enumerate() {
+                if i == selected {
+                  proc.resize(term_area);
+                } else {
+                  proc.resize_lazy(term_area);
+                }
               }
             }
+            // A proc whose resize was deferred while it was in the
+            // background catches up the moment it becomes visible.
+            if let Some(proc) = self.state.get_current_proc_mut() {
+              proc.sync_size();
+            }
           }
 
           render_procs(layout.procs, f, &mut self.state);
           render_term(layout.term, f, &mut self.state);
+          render_stats(layout.stats, f, &self.state);
           render_keymap(layout.keymap, f, &mut self.state, &self.keymap);
           render_zoom_tip(layout.zoom_banner, f, &self.keymap);
 
@@ -202,20 +407,87 @@ impl App {
               Modal::RemoveProc { id: _ } => {
                 render_remove_proc(f.size(), f);
               }
+              Modal::CopySearch { input } => {
+                render_copy_search(f.size(), f, input);
+              }
               Modal::Quit => {
                 render_confirm_quit(f.size(), f);
               }
             }
           }
         })?;
+        self.state.stats.record_frame(draw_started.elapsed());
+        last_render = Instant::now();
+        render_at = None;
       }
 
+      let mut render_timer = match render_at {
+        Some(at) => {
+          tokio::time::sleep_until(tokio::time::Instant::from_std(at))
+            .boxed()
+            .fuse()
+        }
+        None => futures::future::pending().boxed().fuse(),
+      };
+
+      let mut resize_timer = match self.resize_at {
+        Some(at) => {
+          tokio::time::sleep_until(tokio::time::Instant::from_std(at))
+            .boxed()
+            .fuse()
+        }
+        None => futures::future::pending().boxed().fuse(),
+      };
+
+      let mut refresh_timer = match self.refresh_at {
+        Some(at) => {
+          tokio::time::sleep_until(tokio::time::Instant::from_std(at))
+            .boxed()
+            .fuse()
+        }
+        None => futures::future::pending().boxed().fuse(),
+      };
+
+      let mut dirty_notified = {
+        let dirty = self.dirty.clone();
+        async move { dirty.notified().await }.boxed().fuse()
+      };
+
       let loop_action = select! {
-        event = input.next().fuse() => {
-          self.handle_input(event)
+        _ = render_timer => LoopAction::Render,
+        _ = resize_timer => self.apply_pending_resize(),
+        _ = refresh_timer => {
+          self.refresh_at = None;
+          LoopAction::Render
+        }
+        _ = dirty_notified => {
+          let ids = self.dirty.drain();
+          self.handle_dirty_procs(ids)
+        }
+        event = next_input_event(&mut input).fuse() => {
+          let mut action = self.handle_input(event);
+          // Coalesce a burst of ready input events (e.g. a paste arriving
+          // as individual keys) so each proc gets one pty write. Polling
+          // the stream with a throwaway waker here would leave its wake
+          // task armed with that waker and stall all further input, so
+          // the burst is drained through the blocking poll/read API with
+          // a zero timeout instead.
+          while let Ok(true) =
+            crossterm::event::poll(Duration::from_secs(0))
+          {
+            match crossterm::event::read() {
+              Ok(event) => {
+                action = action.merge(self.handle_input(Some(Ok(event))))
+              }
+              Err(_) => break,
+            }
+          }
+          self.flush_proc_input();
+          action
         }
         event = self.upd_rx.recv().fuse() => {
           if let Some(event) = event {
+            stats::upd_received();
             self.handle_proc_update(event)
           } else {
             LoopAction::Skip
@@ -223,7 +495,14 @@ impl App {
         }
         event = self.ev_rx.recv().fuse() => {
           if let Some(event) = event {
-            self.handle_event(&event)
+            let mut action = self.handle_event(&event);
+            // Apply everything already queued (e.g. a pipelined stream of
+            // remote commands) before rendering once for the whole batch.
+            while let Ok(event) = self.ev_rx.try_recv() {
+              action = action.merge(self.handle_event(&event));
+            }
+            self.flush_proc_input();
+            action
           } else {
             LoopAction::Skip
           }
@@ -236,29 +515,74 @@ impl App {
 
       match loop_action {
         LoopAction::Render => {
-          render_needed = true;
-        }
-        LoopAction::Skip => {
-          render_needed = false;
+          // A detached daemon skips drawing entirely; the attach event
+          // arms a render once a client is there to receive it.
+          let detached = self.headless && self.client.lock().unwrap().is_none();
+          if render_at.is_none() && !detached {
+            render_at =
+              Some((last_render + frame_interval).max(Instant::now()));
+          }
         }
+        LoopAction::Skip => (),
         LoopAction::ForceQuit => break,
       };
     }
 
+    if let Some(path) = &self.config.session {
+      if let Err(err) = session::save(path, &self.state.procs) {
+        log::warn!("Failed to save session {:?}: {}", path, err);
+      }
+    }
+
     Ok(())
   }
 
+  /// Flushes input queued during the current batch of events as one pty
+  /// write per proc.
+  fn flush_proc_input(&mut self) {
+    for proc in &mut self.state.procs {
+      proc.flush_input();
+    }
+  }
+
   fn start_procs(&mut self, size: Rect) -> anyhow::Result<()> {
+    let mut session = match &self.config.session {
+      Some(path) if path.exists() => match session::load(path) {
+        Ok(screens) => screens,
+        Err(err) => {
+          log::warn!("Failed to load session {:?}: {}", path, err);
+          HashMap::new()
+        }
+      },
+      _ => HashMap::new(),
+    };
+
     let mut procs = self
       .config
       .procs
       .iter()
       .map(|proc_cfg| {
-        Proc::new(proc_cfg.name.clone(), proc_cfg, self.upd_tx.clone(), size)
+        Proc::new(
+          proc_cfg.name.clone(),
+          proc_cfg,
+          self.upd_tx.clone(),
+          self.dirty.clone(),
+          self.reaper.clone(),
+          self.scheduler.clone(),
+          size,
+          session.remove(&proc_cfg.name),
+        )
       })
       .collect::<Vec<_>>();
 
     self.state.procs.append(&mut procs);
+    self.state.reindex_procs();
+
+    // The initially selected proc counts as selected for lazy autostart.
+    let selected = self.state.selected;
+    if let Some(proc) = self.state.procs.get_mut(selected) {
+      proc.start_if_lazy();
+    }
 
     Ok(())
   }
@@ -267,6 +591,7 @@ impl App {
     &mut self,
     event: Option<crossterm::Result<Event>>,
   ) -> LoopAction {
+    crate::prof_span!("handle_input");
     let event = match event {
       Some(Ok(event)) => event,
       Some(Err(err)) => {
@@ -279,6 +604,48 @@ impl App {
       }
     };
 
+    // The search modal needs mutable access to the current proc while it
+    // is handled, so it is taken out of the state for the duration. Other
+    // modals must be left in place; a blind `take` here would drop them.
+    if matches!(self.state.modal, Some(Modal::CopySearch { .. })) {
+      let Some(Modal::CopySearch { mut input }) = self.state.modal.take()
+      else {
+        unreachable!()
+      };
+      let mut done = false;
+      match event {
+        Event::Key(KeyEvent {
+          code: KeyCode::Enter,
+          modifiers,
+        }) if modifiers.is_empty() => {
+          done = true;
+        }
+        Event::Key(KeyEvent {
+          code: KeyCode::Esc,
+          modifiers,
+        }) if modifiers.is_empty() => {
+          done = true;
+          if let Some(proc) = self.state.get_current_proc_mut() {
+            proc.search_cancel();
+          }
+        }
+        _ => {
+          let req = tui_input::backend::crossterm::to_input_request(event);
+          if let Some(req) = req {
+            input.handle(req);
+            let query = input.value().to_string();
+            if let Some(proc) = self.state.get_current_proc_mut() {
+              proc.search_update(&query);
+            }
+          }
+        }
+      }
+      if !done {
+        self.state.modal = Some(Modal::CopySearch { input });
+      }
+      return LoopAction::Render;
+    }
+
     {
       let mut ret: Option<LoopAction> = None;
       let mut reset_modal = false;
@@ -341,6 +708,8 @@ impl App {
               _ => (),
             }
           }
+          // handled by the early return above
+          Modal::CopySearch { input: _ } => (),
           Modal::Quit => match event {
             Event::Key(KeyEvent {
               code: KeyCode::Char('y'),
@@ -454,22 +823,47 @@ impl App {
           (width, height)
         };
 
-        let area = AppLayout::new(
-          Rect::new(0, 0, width, height),
-          self.state.scope.is_zoomed(),
-          &self.config,
-        )
-        .term_area();
-        for proc in &mut self.state.procs {
-          proc.resize(area);
-        }
+        // Only the settled size is applied; see `apply_pending_resize`.
+        self.pending_resize = Some((width, height));
+        self.resize_at = Some(Instant::now() + RESIZE_DEBOUNCE);
 
-        LoopAction::Render
+        LoopAction::Skip
       }
     }
   }
 
+  /// Applies the settled size once a storm of resize events has quieted
+  /// down. Only the visible proc reflows now; the rest record the size
+  /// and reflow when next selected, so a drag costs one reflow instead
+  /// of one per proc per event.
+  fn apply_pending_resize(&mut self) -> LoopAction {
+    self.resize_at = None;
+    let (width, height) = match self.pending_resize.take() {
+      Some(size) => size,
+      None => return LoopAction::Skip,
+    };
+
+    let area = AppLayout::new(
+      Rect::new(0, 0, width, height),
+      self.state.scope.is_zoomed(),
+      self.state.stats.height(self.state.procs.len()),
+      &self.config,
+    )
+    .term_area();
+    let selected = self.state.selected;
+    for (i, proc) in self.state.procs.iter_mut().enumerate() {
+      if i == selected {
+        proc.resize(area);
+      } else {
+        proc.resize_lazy(area);
+      }
+    }
+
+    LoopAction::Render
+  }
+
   fn handle_event(&mut self, event: &AppEvent) -> LoopAction {
+    crate::prof_span!("handle_event");
     match event {
       AppEvent::Batch { cmds } => {
         let mut ret = LoopAction::Skip;
@@ -634,13 +1028,19 @@ impl App {
             },
             cwd: None,
             env: None,
-            autostart: true,
+            autostart: AutostartConfig::Yes,
+            scrollback: DEFAULT_SCROLLBACK,
+            log: None,
             stop: StopSignal::default(),
           },
           self.upd_tx.clone(),
+          self.dirty.clone(),
+          self.reaper.clone(),
+          self.scheduler.clone(),
           self.get_layout().term_area(),
+          None,
         );
-        self.state.procs.push(proc);
+        self.state.add_proc(proc);
         LoopAction::Render
       }
       AppEvent::ShowRemoveProc => {
@@ -662,17 +1062,25 @@ impl App {
           .state
           .procs
           .retain(|proc| proc.is_up() || proc.id != *id);
+        self.state.reindex_procs();
+        LoopAction::Render
+      }
+
+      AppEvent::ToggleStats => {
+        self.state.stats.show = !self.state.stats.show;
         LoopAction::Render
       }
 
       AppEvent::CopyModeEnter => {
         let switched = match self.state.get_current_proc_mut() {
           Some(proc) => match &mut proc.inst {
-            ProcState::None => false,
+            ProcState::None | ProcState::Starting => false,
             ProcState::Some(inst) => {
-              let screen = inst.vt.read().unwrap().screen().clone();
+              // cheap: rows are copy-on-write
+              let screen = (*inst.screen()).clone();
               let y = (screen.size().0 - 1) as i32;
               proc.copy_mode = CopyMode::Start(screen, Pos { y, x: 0 });
+              proc.copy_search = None;
               true
             }
             ProcState::Error(_) => false,
@@ -687,16 +1095,40 @@ impl App {
       AppEvent::CopyModeLeave => {
         if let Some(proc) = self.state.get_current_proc_mut() {
           proc.copy_mode = CopyMode::None(None);
+          proc.copy_search = None;
+        }
+        LoopAction::Render
+      }
+      AppEvent::CopyModeSearch => {
+        let opened = self
+          .state
+          .get_current_proc_mut()
+          .map_or(false, |proc| proc.search_open());
+        if opened {
+          self.state.modal = Some(Modal::CopySearch {
+            input: Input::default(),
+          });
+        }
+        LoopAction::Render
+      }
+      AppEvent::CopyModeSearchNext => {
+        if let Some(proc) = self.state.get_current_proc_mut() {
+          proc.search_next();
+        }
+        LoopAction::Render
+      }
+      AppEvent::CopyModeSearchPrev => {
+        if let Some(proc) = self.state.get_current_proc_mut() {
+          proc.search_prev();
         }
         LoopAction::Render
       }
       AppEvent::CopyModeMove { dir } => {
         if let Some(proc) = self.state.get_current_proc_mut() {
           match &proc.inst {
-            ProcState::None => (),
+            ProcState::None | ProcState::Starting => (),
             ProcState::Some(inst) => {
-              let vt = inst.vt.read().unwrap();
-              let screen = vt.screen();
+              let screen = inst.screen();
               match &mut proc.copy_mode {
                 CopyMode::None(_) => (),
                 CopyMode::Start(_, pos_) | CopyMode::Range(_, _, pos_) => {
@@ -745,14 +1177,40 @@ impl App {
         if let Some(proc) = self.state.get_current_proc_mut() {
           if let CopyMode::Range(screen, start, end) = &proc.copy_mode {
             let (low, high) = Pos::to_low_high(start, end);
-            let text = screen.get_selected_text(low.x, low.y, high.x, high.y);
 
-            let mut stdout = std::io::stdout().lock();
+            // Stream the selection through an incremental base64 encoder
+            // straight into the terminal, so a huge selection is copied
+            // in constant memory instead of being materialized twice. In
+            // daemon mode stdout belongs to the detached server process,
+            // so the sequence goes to the attached client the same way
+            // rendered frames do.
             use std::io::Write;
-            let _r =
-              write!(&mut stdout, "\x1b]52;;{}\x07", base64::encode(&text));
+            let out = if self.headless {
+              TermOut::Client(self.client.clone())
+            } else {
+              TermOut::Stdout(std::io::stdout())
+            };
+            let mut out = std::io::BufWriter::new(out);
+            let _r = out.write_all(b"\x1b]52;;");
+            {
+              let mut encoder =
+                base64::write::EncoderWriter::new(&mut out, base64::STANDARD);
+              screen.for_each_selected_text(
+                low.x,
+                low.y,
+                high.x,
+                high.y,
+                |text| {
+                  let _r = encoder.write_all(text.as_bytes());
+                },
+              );
+              let _r = encoder.finish();
+            }
+            let _r = out.write_all(b"\x07");
+            let _r = out.flush();
           }
           proc.copy_mode = CopyMode::None(None);
+          proc.copy_search = None;
         }
         LoopAction::Render
       }
@@ -763,22 +1221,55 @@ impl App {
         }
         LoopAction::Skip
       }
+      AppEvent::SendText { text } => {
+        if let Some(proc) = self.state.get_current_proc_mut() {
+          proc.send_text(text);
+        }
+        LoopAction::Skip
+      }
+
+      AppEvent::Attach { width, height } => {
+        *self.client_size.lock().unwrap() = (*width, *height);
+        // Repaint everything so the client starts from the current
+        // screens instead of replaying history.
+        let _result = self.terminal.clear();
+        LoopAction::Render
+      }
+      AppEvent::Keypress { key } => {
+        // Keys from an attached client go through the same dispatch as
+        // local terminal input, keymap included.
+        let event = Event::Key(KeyEvent::new(*key.code(), *key.mods()));
+        self.handle_input(Some(Ok(event)))
+      }
     }
   }
 
-  fn handle_proc_update(&mut self, event: (usize, ProcUpdate)) -> LoopAction {
-    match event.1 {
-      ProcUpdate::Render => {
-        let cur_proc_id =
-          self.state.get_current_proc().map_or(usize::MAX, |p| p.id);
-        if let Some(proc) = self.state.get_proc_mut(event.0) {
-          if proc.id != cur_proc_id {
-            proc.changed = true;
-          }
-          return LoopAction::Render;
+  /// Applies a batch of drained dirty flags. Output of the current proc
+  /// is visible, so it always schedules a render. A background proc only
+  /// forces one when its changed marker first lights up; after that its
+  /// steady spew changes nothing on screen except the rate column, which
+  /// is refreshed at `ACTIVITY_REFRESH` instead of per chunk.
+  fn handle_dirty_procs(&mut self, ids: Vec<usize>) -> LoopAction {
+    let cur_proc_id =
+      self.state.get_current_proc().map_or(usize::MAX, |p| p.id);
+    let mut action = LoopAction::Skip;
+    for id in ids {
+      if let Some(proc) = self.state.get_proc_mut(id) {
+        if proc.id == cur_proc_id {
+          action = action.merge(LoopAction::Render);
+        } else if !proc.changed {
+          proc.changed = true;
+          action = action.merge(LoopAction::Render);
+        } else if self.refresh_at.is_none() {
+          self.refresh_at = Some(Instant::now() + ACTIVITY_REFRESH);
         }
-        LoopAction::Skip
       }
+    }
+    action
+  }
+
+  fn handle_proc_update(&mut self, event: (usize, ProcUpdate)) -> LoopAction {
+    match event.1 {
       ProcUpdate::Stopped => {
         if let Some(proc) = self.state.get_proc_mut(event.0) {
           if proc.to_restart {
@@ -789,6 +1280,16 @@ impl App {
         LoopAction::Render
       }
       ProcUpdate::Started => LoopAction::Render,
+      ProcUpdate::Spawned(spawned) => {
+        let quitting = self.state.quitting;
+        if let Some(proc) = self.state.get_proc_mut(event.0) {
+          proc.install_inst(spawned);
+          if quitting {
+            proc.stop();
+          }
+        }
+        LoopAction::Render
+      }
     }
   }
 
@@ -796,25 +1297,39 @@ impl App {
     AppLayout::new(
       self.terminal.get_frame().size(),
       self.state.scope.is_zoomed(),
+      self.state.stats.height(self.state.procs.len()),
       &self.config,
     )
   }
 }
 
+/// Resolves to the next local terminal event; pends forever when running
+/// headless.
+async fn next_input_event(
+  input: &mut Option<EventStream>,
+) -> Option<crossterm::Result<Event>> {
+  match input {
+    Some(input) => input.next().await,
+    None => futures::future::pending().await,
+  }
+}
+
 struct AppLayout {
   procs: Rect,
   term: Rect,
+  stats: Rect,
   keymap: Rect,
   zoom_banner: Rect,
 }
 
 impl AppLayout {
-  pub fn new(area: Rect, zoom: bool, config: &Config) -> Self {
+  pub fn new(area: Rect, zoom: bool, stats_h: u16, config: &Config) -> Self {
     let keymap_h = if zoom || config.hide_keymap_window {
       0
     } else {
       3
     };
+    let stats_h = if zoom { 0 } else { stats_h };
     let procs_w = if zoom {
       0
     } else {
@@ -823,7 +1338,11 @@ impl AppLayout {
     let zoom_banner_h = if zoom { 1 } else { 0 };
     let top_bot = Layout::default()
       .direction(Direction::Vertical)
-      .constraints([Constraint::Min(1), Constraint::Length(keymap_h)])
+      .constraints([
+        Constraint::Min(1),
+        Constraint::Length(stats_h),
+        Constraint::Length(keymap_h),
+      ])
       .split(area);
     let chunks = Layout::default()
       .direction(Direction::Horizontal)
@@ -837,7 +1356,8 @@ impl AppLayout {
     Self {
       procs: chunks[0],
       term: term_zoom[1],
-      keymap: top_bot[1],
+      stats: top_bot[1],
+      keymap: top_bot[2],
       zoom_banner: term_zoom[0],
     }
   }
@@ -2,6 +2,7 @@ use std::{ffi::OsString, path::PathBuf, str::FromStr};
 
 use anyhow::{bail, Result};
 use indexmap::IndexMap;
+#[cfg(windows)]
 use portable_pty::CommandBuilder;
 use serde::{Deserialize, Serialize};
 use serde_yaml::Value;
@@ -19,9 +20,13 @@ pub struct ConfigContext {
 pub struct Config {
   pub procs: Vec<ProcConfig>,
   pub server: Option<ServerConfig>,
+  /// Save screen history here on quit and restore it on startup (see
+  /// `session.rs`).
+  pub session: Option<PathBuf>,
   pub hide_keymap_window: bool,
   pub mouse_scroll_speed: usize,
   pub proc_list_width: usize,
+  pub render_fps: usize,
 }
 
 impl Config {
@@ -55,12 +60,31 @@ impl Config {
       None
     };
 
+    let session = match config.get(&Value::from("session")) {
+      Some(session) => {
+        let session = session.as_str()?;
+        let mut buf = OsString::new();
+        if let Some(rest) = session.strip_prefix("<CONFIG_DIR>") {
+          if let Some(parent) = dunce::canonicalize(&ctx.path)?.parent() {
+            buf.push(parent);
+          }
+          buf.push(rest);
+        } else {
+          buf.push(session);
+        }
+        Some(PathBuf::from(buf))
+      }
+      None => None,
+    };
+
     let config = Config {
       procs,
       server,
+      session,
       hide_keymap_window: settings.hide_keymap_window,
       mouse_scroll_speed: settings.mouse_scroll_speed,
       proc_list_width: settings.proc_list_width,
+      render_fps: settings.render_fps,
     };
 
     Ok(config)
@@ -70,19 +94,26 @@ impl Config {
     Self {
       procs: Vec::new(),
       server: None,
+      session: None,
       hide_keymap_window: settings.hide_keymap_window,
       mouse_scroll_speed: settings.mouse_scroll_speed,
       proc_list_width: settings.proc_list_width,
+      render_fps: settings.render_fps,
     }
   }
 }
 
+pub const DEFAULT_SCROLLBACK: usize = 1000;
+
 pub struct ProcConfig {
   pub name: String,
   pub cmd: CmdConfig,
   pub cwd: Option<OsString>,
   pub env: Option<IndexMap<String, Option<String>>>,
-  pub autostart: bool,
+  pub autostart: AutostartConfig,
+  pub scrollback: usize,
+  /// Tee raw pty output into this file (see `proc_log.rs`).
+  pub log: Option<PathBuf>,
 
   pub stop: StopSignal,
 }
@@ -104,7 +135,9 @@ impl ProcConfig {
         },
         cwd: None,
         env: None,
-        autostart: true,
+        autostart: AutostartConfig::Yes,
+        scrollback: DEFAULT_SCROLLBACK,
+        log: None,
         stop: StopSignal::default(),
       })),
       Value::Sequence(_) => {
@@ -119,7 +152,9 @@ impl ProcConfig {
           cmd: CmdConfig::Cmd { cmd },
           cwd: None,
           env: None,
-          autostart: true,
+          autostart: AutostartConfig::Yes,
+          scrollback: DEFAULT_SCROLLBACK,
+          log: None,
           stop: StopSignal::default(),
         }))
       }
@@ -223,9 +258,40 @@ impl ProcConfig {
           None => env,
         };
 
-        let autostart = map
-          .get(&Value::from("autostart"))
-          .map_or(Ok(true), |v| v.as_bool())?;
+        let autostart = match map.get(&Value::from("autostart")) {
+          Some(v) => match v.raw() {
+            Value::String(s) if s == "lazy" => AutostartConfig::Lazy,
+            _ => {
+              if v.as_bool()? {
+                AutostartConfig::Yes
+              } else {
+                AutostartConfig::No
+              }
+            }
+          },
+          None => AutostartConfig::Yes,
+        };
+
+        let scrollback = map
+          .get(&Value::from("scrollback"))
+          .map_or(Ok(DEFAULT_SCROLLBACK), |v| v.as_usize())?;
+
+        let log = match map.get(&Value::from("log")) {
+          Some(log) => {
+            let log = log.as_str()?;
+            let mut buf = OsString::new();
+            if let Some(rest) = log.strip_prefix("<CONFIG_DIR>") {
+              if let Some(parent) = dunce::canonicalize(&ctx.path)?.parent() {
+                buf.push(parent);
+              }
+              buf.push(rest);
+            } else {
+              buf.push(log);
+            }
+            Some(PathBuf::from(buf))
+          }
+          None => None,
+        };
 
         let stop_signal = if let Some(val) = map.get(&Value::from("stop")) {
           serde_yaml::from_value(val.raw().clone())?
@@ -239,6 +305,8 @@ impl ProcConfig {
           cwd,
           env,
           autostart,
+          scrollback,
+          log,
           stop: stop_signal,
         }))
       }
@@ -246,12 +314,27 @@ impl ProcConfig {
   }
 }
 
+/// Whether a process is spawned when mprocs starts. `Lazy` defers the
+/// spawn until the process is first selected or started explicitly.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub enum AutostartConfig {
+  Yes,
+  No,
+  Lazy,
+}
+
 pub enum ServerConfig {
   Tcp(String),
+  /// Unix domain socket at the given path. Spelled `unix:<path>` in the
+  /// config and on the command line.
+  Unix(String),
 }
 
 impl ServerConfig {
   pub fn from_str(server_addr: &str) -> Result<Self> {
+    if let Some(path) = server_addr.strip_prefix("unix:") {
+      return Ok(Self::Unix(path.to_string()));
+    }
     Ok(Self::Tcp(server_addr.to_string()))
   }
 }
@@ -263,30 +346,72 @@ pub enum CmdConfig {
   Shell { shell: String },
 }
 
-impl From<&ProcConfig> for CommandBuilder {
+/// Fully resolved command of a process. Unlike
+/// `portable_pty::CommandBuilder` it keeps its parts accessible, so the
+/// unix spawn path can build a `std::process::Command` out of it.
+#[derive(Clone)]
+pub struct CmdSpec {
+  pub argv: Vec<String>,
+  pub env: Option<IndexMap<String, Option<String>>>,
+  pub cwd: Option<OsString>,
+}
+
+impl From<&ProcConfig> for CmdSpec {
   fn from(cfg: &ProcConfig) -> Self {
-    let mut cmd = match &cfg.cmd {
-      CmdConfig::Cmd { cmd } => {
-        let (head, tail) = cmd.split_at(1);
-        let mut cmd = CommandBuilder::new(&head[0]);
-        cmd.args(tail);
-        cmd
-      }
+    let argv = match &cfg.cmd {
+      CmdConfig::Cmd { cmd } => cmd.clone(),
       CmdConfig::Shell { shell } => {
         if cfg!(target_os = "windows") {
-          let mut cmd = CommandBuilder::new("cmd");
-          cmd.args(["/C", &shell]);
-          cmd
+          vec!["cmd".to_string(), "/C".to_string(), shell.clone()]
         } else {
-          let mut cmd = CommandBuilder::new("sh");
-          cmd.arg("-c");
-          cmd.arg(&shell);
-          cmd
+          vec!["sh".to_string(), "-c".to_string(), shell.clone()]
         }
       }
     };
 
-    if let Some(env) = &cfg.env {
+    CmdSpec {
+      argv,
+      env: cfg.env.clone(),
+      cwd: cfg.cwd.clone(),
+    }
+  }
+}
+
+#[cfg(not(windows))]
+impl CmdSpec {
+  pub fn to_std_command(&self) -> std::process::Command {
+    let (head, tail) = self.argv.split_at(1);
+    let mut cmd = std::process::Command::new(&head[0]);
+    cmd.args(tail);
+
+    if let Some(env) = &self.env {
+      for (k, v) in env {
+        if let Some(v) = v {
+          cmd.env(k, v);
+        } else {
+          cmd.env_remove(k);
+        }
+      }
+    }
+
+    if let Some(cwd) = &self.cwd {
+      cmd.current_dir(cwd);
+    } else if let Ok(cwd) = std::env::current_dir() {
+      cmd.current_dir(cwd);
+    }
+
+    cmd
+  }
+}
+
+#[cfg(windows)]
+impl From<&CmdSpec> for CommandBuilder {
+  fn from(spec: &CmdSpec) -> Self {
+    let (head, tail) = spec.argv.split_at(1);
+    let mut cmd = CommandBuilder::new(&head[0]);
+    cmd.args(tail);
+
+    if let Some(env) = &spec.env {
       for (k, v) in env {
         if let Some(v) = v {
           cmd.env(k, v);
@@ -296,7 +421,7 @@ impl From<&ProcConfig> for CommandBuilder {
       }
     }
 
-    if let Some(cwd) = &cfg.cwd {
+    if let Some(cwd) = &spec.cwd {
       cmd.cwd(cwd);
     } else if let Ok(cwd) = std::env::current_dir() {
       cmd.cwd(cwd);
@@ -1,29 +1,182 @@
+use std::io::Write;
+
+use crossterm::{
+  event::{Event, EventStream},
+  execute,
+  terminal::{
+    disable_raw_mode, enable_raw_mode, EnterAlternateScreen,
+    LeaveAlternateScreen,
+  },
+};
+use futures::{future::FutureExt, select, StreamExt};
 use serde_yaml::Value;
+use tokio::io::{AsyncRead, AsyncReadExt, AsyncWrite, AsyncWriteExt};
 
 use crate::{
   config::{Config, ServerConfig},
   event::AppEvent,
+  key::Key,
 };
 
-pub async fn run_ctl(ctl: &str, config: &Config) -> anyhow::Result<()> {
-  let event: AppEvent = match serde_yaml::from_str(ctl) {
-    Ok(event) => event,
-    Err(err) => {
-      let val: Value = serde_yaml::from_str(ctl)?;
-      println!(
-        "Remote command parsed as:\n{}",
-        serde_yaml::to_string(&val)?
-      );
-      return Err(err.into());
+/// Remote commands are framed as a little-endian u32 length followed by a
+/// MessagePack-encoded `AppEvent`, so one connection can carry any number
+/// of pipelined commands without a reconnect or a yaml parse per command.
+pub fn encode_frame(event: &AppEvent) -> anyhow::Result<Vec<u8>> {
+  let payload = rmp_serde::to_vec_named(event)?;
+  let mut buf = Vec::with_capacity(4 + payload.len());
+  buf.extend_from_slice(&(payload.len() as u32).to_le_bytes());
+  buf.extend_from_slice(&payload);
+  Ok(buf)
+}
+
+/// Reads the next command frame. Returns `None` on a clean end of stream.
+pub async fn read_frame<R: AsyncReadExt + Unpin>(
+  socket: &mut R,
+) -> anyhow::Result<Option<AppEvent>> {
+  let mut len = [0u8; 4];
+  match socket.read_exact(&mut len).await {
+    Ok(_) => (),
+    Err(err) if err.kind() == std::io::ErrorKind::UnexpectedEof => {
+      return Ok(None)
     }
+    Err(err) => return Err(err.into()),
+  }
+  let mut payload = vec![0u8; u32::from_le_bytes(len) as usize];
+  socket.read_exact(&mut payload).await?;
+  Ok(Some(rmp_serde::from_slice(&payload)?))
+}
+
+pub async fn run_ctl(ctl: &str, config: &Config) -> anyhow::Result<()> {
+  // A single command or a yaml list of commands to pipeline over one
+  // connection.
+  let events: Vec<AppEvent> = match serde_yaml::from_str::<AppEvent>(ctl) {
+    Ok(event) => vec![event],
+    Err(err) => match serde_yaml::from_str::<Vec<AppEvent>>(ctl) {
+      Ok(events) => events,
+      Err(_) => {
+        let val: Value = serde_yaml::from_str(ctl)?;
+        println!(
+          "Remote command parsed as:\n{}",
+          serde_yaml::to_string(&val)?
+        );
+        return Err(err.into());
+      }
+    },
   };
 
-  let socket = match &config.server {
-    Some(ServerConfig::Tcp(addr)) => std::net::TcpStream::connect(addr)?,
+  let mut socket: Box<dyn Write> = match &config.server {
+    Some(ServerConfig::Tcp(addr)) => {
+      Box::new(std::net::TcpStream::connect(addr)?)
+    }
+    #[cfg(unix)]
+    Some(ServerConfig::Unix(path)) => {
+      Box::new(std::os::unix::net::UnixStream::connect(path)?)
+    }
+    #[cfg(not(unix))]
+    Some(ServerConfig::Unix(_)) => {
+      anyhow::bail!("Unix sockets are not supported on this platform.")
+    }
     None => anyhow::bail!("Server address is not defined."),
   };
 
-  serde_yaml::to_writer(socket, &event).unwrap();
+  for event in &events {
+    socket.write_all(&encode_frame(event)?)?;
+  }
+  socket.flush()?;
 
   Ok(())
 }
+
+/// Attaches to a daemon (`--daemon`) over the remote control socket: the
+/// daemon streams rendered frames to this terminal and keys typed here
+/// are sent back as `Keypress` commands. `C-q` detaches, leaving the
+/// daemon and its processes running.
+pub async fn run_attach(config: &Config) -> anyhow::Result<()> {
+  let (mut reader, mut writer): (
+    Box<dyn AsyncRead + Unpin>,
+    Box<dyn AsyncWrite + Unpin>,
+  ) = match &config.server {
+    Some(ServerConfig::Tcp(addr)) => {
+      let socket = tokio::net::TcpStream::connect(addr).await?;
+      let (read, write) = socket.into_split();
+      (Box::new(read), Box::new(write))
+    }
+    #[cfg(unix)]
+    Some(ServerConfig::Unix(path)) => {
+      let socket = tokio::net::UnixStream::connect(path).await?;
+      let (read, write) = socket.into_split();
+      (Box::new(read), Box::new(write))
+    }
+    #[cfg(not(unix))]
+    Some(ServerConfig::Unix(_)) => {
+      anyhow::bail!("Unix sockets are not supported on this platform.")
+    }
+    None => anyhow::bail!("Server address is not defined."),
+  };
+
+  let detach_key = Key::parse("<C-q>")?;
+
+  enable_raw_mode()?;
+  execute!(std::io::stdout(), EnterAlternateScreen)?;
+
+  let result: anyhow::Result<()> = async {
+    let (width, height) = crossterm::terminal::size()?;
+    writer
+      .write_all(&encode_frame(&AppEvent::Attach { width, height })?)
+      .await?;
+    writer.flush().await?;
+
+    let mut input = EventStream::new();
+    let mut buf = [0u8; 8192];
+    loop {
+      select! {
+        read = reader.read(&mut buf).fuse() => match read {
+          // The daemon quit.
+          Ok(0) => return Ok(()),
+          Ok(len) => {
+            let mut stdout = std::io::stdout().lock();
+            stdout.write_all(&buf[..len])?;
+            stdout.flush()?;
+          }
+          Err(err) => return Err(err.into()),
+        },
+        event = input.next().fuse() => match event {
+          Some(Ok(Event::Key(key))) => {
+            let key = Key::from(key);
+            if key == detach_key {
+              return Ok(());
+            }
+            writer
+              .write_all(&encode_frame(&AppEvent::Keypress { key })?)
+              .await?;
+            writer.flush().await?;
+          }
+          Some(Ok(Event::Resize(width, height))) => {
+            writer
+              .write_all(&encode_frame(&AppEvent::Attach { width, height })?)
+              .await?;
+            writer.flush().await?;
+          }
+          Some(Ok(_)) => (),
+          Some(Err(err)) => return Err(err.into()),
+          None => return Ok(()),
+        },
+      }
+    }
+  }
+  .await;
+
+  execute!(std::io::stdout(), LeaveAlternateScreen)?;
+  disable_raw_mode()?;
+
+  // `EventStream` leaves a thread blocked reading the tty that only
+  // unblocks on the next keypress, which would keep a detached client
+  // around until one arrives. The terminal is restored, so end here.
+  match result {
+    Ok(()) => std::process::exit(0),
+    Err(err) => {
+      eprintln!("Error: {}", err);
+      std::process::exit(1);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+use std::sync::Mutex;
+
+use tokio::sync::Notify;
+
+/// Coalescing "needs render" flags, one bit per proc id.
+///
+/// Pty readers mark their proc dirty instead of queueing a message per
+/// read, so a proc spewing output while the UI is stalled costs one bit
+/// instead of an unbounded message backlog. The main loop waits on
+/// `notified` and drains every set bit at once, rendering a single frame
+/// for the whole batch. Memory is O(procs) regardless of output rate.
+pub struct DirtyProcs {
+  bits: Mutex<Vec<u64>>,
+  notify: Notify,
+}
+
+impl DirtyProcs {
+  pub fn new() -> Self {
+    DirtyProcs {
+      bits: Mutex::new(Vec::new()),
+      notify: Notify::new(),
+    }
+  }
+
+  /// Marks a proc as needing a render. Marking an already dirty proc is a
+  /// no-op, which is what bounds the cost of an output storm.
+  pub fn mark(&self, id: usize) {
+    let mut bits = self.bits.lock().unwrap();
+    let word = id / 64;
+    if bits.len() <= word {
+      bits.resize(word + 1, 0);
+    }
+    let bit = 1u64 << (id % 64);
+    if bits[word] & bit == 0 {
+      bits[word] |= bit;
+      crate::stats::upd_sent();
+      self.notify.notify_one();
+    }
+  }
+
+  /// Clears all dirty bits and returns the ids that were set.
+  pub fn drain(&self) -> Vec<usize> {
+    let mut bits = self.bits.lock().unwrap();
+    let mut ids = Vec::new();
+    for (word_i, word) in bits.iter_mut().enumerate() {
+      while *word != 0 {
+        let bit = word.trailing_zeros() as usize;
+        *word &= *word - 1;
+        ids.push(word_i * 64 + bit);
+        crate::stats::upd_received();
+      }
+    }
+    ids
+  }
+
+  /// Completes once at least one proc has been marked. A mark that races
+  /// with a drain can leave a stale wakeup behind; callers should treat an
+  /// empty `drain` as a no-op.
+  pub async fn notified(&self) {
+    self.notify.notified().await;
+  }
+}
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+
+  #[test]
+  fn mark_coalesces() {
+    let dirty = DirtyProcs::new();
+    for _ in 0..1000 {
+      dirty.mark(3);
+      dirty.mark(70);
+    }
+    assert_eq!(dirty.drain(), vec![3, 70]);
+    assert_eq!(dirty.drain(), Vec::<usize>::new());
+  }
+}
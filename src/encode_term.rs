@@ -29,16 +29,19 @@ impl Default for KeyCodeEncodeModes {
   }
 }
 
-/// Returns the xterm compatible byte sequence that represents this KeyCode
-/// and Modifier combination.
-pub fn encode_key(key: &Key, modes: KeyCodeEncodeModes) -> Result<String> {
+/// Appends the xterm compatible byte sequence that represents this KeyCode
+/// and Modifier combination to `buf`, so bursts of keys can share one
+/// reusable buffer instead of allocating a `String` per key.
+pub fn encode_key(
+  key: &Key,
+  modes: KeyCodeEncodeModes,
+  buf: &mut String,
+) -> Result<()> {
   use KeyCode::*;
 
   let code = key.code().clone();
   let mods = key.mods().clone();
 
-  let mut buf = String::new();
-
   let code = normalize_shift_to_upper_case(code, &mods);
   // Normalize the modifier state for Char's that are uppercase; remove
   // the SHIFT modifier so that reduce ambiguity below
@@ -67,12 +70,12 @@ pub fn encode_key(key: &Key, modes: KeyCodeEncodeModes) -> Result<String> {
         && mods.contains(KeyModifiers::CONTROL)
         && modes.enable_csi_u_key_encoding =>
     {
-      csi_u_encode(&mut buf, c, mods, modes.enable_csi_u_key_encoding)?;
+      csi_u_encode(buf, c, mods, modes.enable_csi_u_key_encoding)?;
     }
     Char(c)
       if c.is_ascii_uppercase() && mods.contains(KeyModifiers::CONTROL) =>
     {
-      csi_u_encode(&mut buf, c, mods, modes.enable_csi_u_key_encoding)?;
+      csi_u_encode(buf, c, mods, modes.enable_csi_u_key_encoding)?;
     }
 
     Char(c)
@@ -110,7 +113,7 @@ pub fn encode_key(key: &Key, modes: KeyCodeEncodeModes) -> Result<String> {
       if mods.contains(KeyModifiers::SHIFT)
         || mods.contains(KeyModifiers::CONTROL)
       {
-        csi_u_encode(&mut buf, c, mods, modes.enable_csi_u_key_encoding)?;
+        csi_u_encode(buf, c, mods, modes.enable_csi_u_key_encoding)?;
       } else {
         if mods.contains(KeyModifiers::ALT) {
           buf.push(0x1b as char);
@@ -142,7 +145,7 @@ pub fn encode_key(key: &Key, modes: KeyCodeEncodeModes) -> Result<String> {
       if mods.is_empty() {
         buf.push(c);
       } else {
-        csi_u_encode(&mut buf, c, mods, modes.enable_csi_u_key_encoding)?;
+        csi_u_encode(buf, c, mods, modes.enable_csi_u_key_encoding)?;
       }
     }
 
@@ -247,7 +250,7 @@ pub fn encode_key(key: &Key, modes: KeyCodeEncodeModes) -> Result<String> {
     BackTab | Null => todo!(),
   };
 
-  Ok(buf)
+  Ok(())
 }
 
 fn encode_modifiers(mods: KeyModifiers) -> u8 {
@@ -36,13 +36,22 @@ pub enum AppEvent {
   ScrollDown,
   ScrollUp,
 
+  ToggleStats,
+
   CopyModeEnter,
+  CopyModeSearch,
+  CopyModeSearchNext,
+  CopyModeSearchPrev,
   CopyModeLeave,
   CopyModeMove { dir: CopyMove },
   CopyModeEnd,
   CopyModeCopy,
 
   SendKey { key: Key },
+  SendText { text: String },
+
+  Attach { width: u16, height: u16 },
+  Keypress { key: Key },
 }
 
 impl AppEvent {
@@ -76,7 +85,11 @@ impl AppEvent {
       }
       AppEvent::ScrollDown => "Scroll down".to_string(),
       AppEvent::ScrollUp => "Scroll up".to_string(),
+      AppEvent::ToggleStats => "Toggle stats pane".to_string(),
       AppEvent::CopyModeEnter => "Enter copy mode".to_string(),
+      AppEvent::CopyModeSearch => "Search".to_string(),
+      AppEvent::CopyModeSearchNext => "Next match".to_string(),
+      AppEvent::CopyModeSearchPrev => "Previous match".to_string(),
       AppEvent::CopyModeLeave => "Leave copy mode".to_string(),
       AppEvent::CopyModeMove { dir } => {
         format!("Move selection cursor {}", dir)
@@ -84,6 +97,13 @@ impl AppEvent {
       AppEvent::CopyModeEnd => "Select end position".to_string(),
       AppEvent::CopyModeCopy => "Copy selected text".to_string(),
       AppEvent::SendKey { key } => format!("Send {} key", key.to_string()),
+      AppEvent::SendText { text } => format!("Send text {:?}", text),
+      AppEvent::Attach { width, height } => {
+        format!("Attach a {}x{} client", width, height)
+      }
+      AppEvent::Keypress { key } => {
+        format!("Press {} key", key.to_string())
+      }
     }
   }
 }
@@ -0,0 +1,31 @@
+pub mod app;
+pub mod config;
+pub mod ctl;
+pub mod dirty;
+pub mod encode_term;
+pub mod event;
+pub mod key;
+pub mod keymap;
+pub mod package_json;
+pub mod proc;
+pub mod proc_log;
+pub mod profiling;
+pub mod pty;
+pub mod reaper;
+pub mod scheduler;
+pub mod session;
+pub mod settings;
+pub mod state;
+pub mod stats;
+pub mod term_buf;
+pub mod theme;
+pub mod ui_add_proc;
+pub mod ui_confirm_quit;
+pub mod ui_copy_search;
+pub mod ui_keymap;
+pub mod ui_procs;
+pub mod ui_remove_proc;
+pub mod ui_stats;
+pub mod ui_term;
+pub mod ui_zoom_tip;
+pub mod yaml_val;
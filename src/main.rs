@@ -1,39 +1,20 @@
-mod app;
-mod config;
-mod ctl;
-mod encode_term;
-mod event;
-mod key;
-mod keymap;
-mod package_json;
-mod proc;
-mod settings;
-mod state;
-mod theme;
-mod ui_add_proc;
-mod ui_confirm_quit;
-mod ui_keymap;
-mod ui_procs;
-mod ui_remove_proc;
-mod ui_term;
-mod ui_zoom_tip;
-mod yaml_val;
-
 use std::path::Path;
 
 use anyhow::{bail, Result};
 use clap::{arg, command, ArgMatches};
-use config::{CmdConfig, Config, ConfigContext, ProcConfig, ServerConfig};
-use ctl::run_ctl;
 use flexi_logger::FileSpec;
-use keymap::Keymap;
-use package_json::load_npm_procs;
-use proc::StopSignal;
+use mprocs::app::App;
+use mprocs::config::{
+  AutostartConfig, CmdConfig, Config, ConfigContext, ProcConfig, ServerConfig,
+  DEFAULT_SCROLLBACK,
+};
+use mprocs::ctl::{run_attach, run_ctl};
+use mprocs::keymap::Keymap;
+use mprocs::package_json::load_npm_procs;
+use mprocs::proc::StopSignal;
+use mprocs::settings::Settings;
+use mprocs::yaml_val::Val;
 use serde_yaml::Value;
-use settings::Settings;
-use yaml_val::Val;
-
-use crate::app::App;
 
 #[tokio::main]
 async fn main() -> Result<(), std::io::Error> {
@@ -44,6 +25,11 @@ async fn main() -> Result<(), std::io::Error> {
     .start()
     .unwrap();
 
+  // Keep the guard alive for the whole run: it writes the trace file on
+  // drop.
+  #[cfg(feature = "profiling")]
+  let _profiling = mprocs::profiling::init();
+
   match run_app().await {
     Ok(()) => Ok(()),
     Err(err) => {
@@ -58,6 +44,8 @@ async fn run_app() -> anyhow::Result<()> {
     .arg(arg!(-c --config [PATH] "Config path [default: mprocs.yaml]"))
     .arg(arg!(-s --server [PATH] "Remote control server address. Example: 127.0.0.1:4050."))
     .arg(arg!(--ctl [YAML] "Send yaml/json encoded command to running mprocs"))
+    .arg(arg!(--daemon "Run without a terminal. Requires a server address; attach with --attach"))
+    .arg(arg!(--attach "Attach to a running daemon. Detach with C-q"))
     .arg(arg!(--names [NAMES] "Names for processes provided by cli arguments. Separated by comma."))
     .arg(arg!(--npm "Run scripts from package.json. Scripts are not started by default."))
     .arg(arg!([COMMANDS]... "Commands to run (if omitted, commands from config will be run)"))
@@ -97,6 +85,10 @@ async fn run_app() -> anyhow::Result<()> {
       return run_ctl(matches.value_of("ctl").unwrap(), &config).await;
     }
 
+    if matches.is_present("attach") {
+      return run_attach(&config).await;
+    }
+
     if let Some(cmds) = matches.values_of("COMMANDS") {
       let names = matches
         .value_of("names")
@@ -113,7 +105,9 @@ async fn run_app() -> anyhow::Result<()> {
           },
           env: None,
           cwd: None,
-          autostart: true,
+          autostart: AutostartConfig::Yes,
+          scrollback: DEFAULT_SCROLLBACK,
+          log: None,
           stop: StopSignal::default(),
         })
         .collect::<Vec<_>>();
@@ -127,7 +121,14 @@ async fn run_app() -> anyhow::Result<()> {
     config
   };
 
-  let app = App::from_config_file(config, keymap)?;
+  let headless = matches.is_present("daemon");
+  if headless && config.server.is_none() {
+    bail!(
+      "Daemon mode requires a server address (-s or `server` in the config)."
+    );
+  }
+
+  let app = App::from_config_file(config, keymap, headless)?;
   app.run().await
 }
 
@@ -5,7 +5,7 @@ use indexmap::IndexMap;
 use serde::Deserialize;
 
 use crate::{
-  config::{CmdConfig, ProcConfig},
+  config::{AutostartConfig, CmdConfig, ProcConfig, DEFAULT_SCROLLBACK},
   proc::StopSignal,
 };
 
@@ -43,7 +43,9 @@ pub fn load_npm_procs() -> Result<Vec<ProcConfig>> {
     cmd: CmdConfig::Shell { shell: cmd },
     cwd: None,
     env: Some(env.clone()),
-    autostart: false,
+    autostart: AutostartConfig::No,
+    scrollback: DEFAULT_SCROLLBACK,
+    log: None,
 
     stop: StopSignal::default(),
   });
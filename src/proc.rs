@@ -1,31 +1,46 @@
 use std::fmt::Debug;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
-use std::sync::{Arc, RwLock};
-use std::thread::{self, spawn};
-use std::time::Duration;
+use std::sync::{Arc, Mutex, RwLock};
 
 use assert_matches::assert_matches;
 use crossterm::event::{MouseButton, MouseEvent, MouseEventKind};
-use portable_pty::MasterPty;
-use portable_pty::{native_pty_system, ChildKiller, CommandBuilder, PtySize};
 use serde::{Deserialize, Serialize};
 use tokio::sync::mpsc::UnboundedSender;
-use tokio::task::spawn_blocking;
 use tui::layout::Rect;
+use unicode_width::UnicodeWidthStr as _;
 use vt100::MouseProtocolMode;
 
-use crate::config::{Config, ProcConfig};
+use crate::config::{AutostartConfig, CmdSpec, Config, ProcConfig};
+use crate::dirty::DirtyProcs;
 use crate::encode_term::{encode_key, encode_mouse_event, KeyCodeEncodeModes};
 use crate::key::Key;
+use crate::proc_log::ProcLog;
+use crate::pty::Pty;
+use crate::reaper::Reaper;
+use crate::scheduler::ParseScheduler;
+use crate::stats::RateMeter;
+
+#[cfg(windows)]
+use portable_pty::{native_pty_system, ChildKiller, CommandBuilder, PtySize};
+#[cfg(windows)]
+use std::thread;
+#[cfg(windows)]
+use std::time::Duration;
+#[cfg(windows)]
+use tokio::task::spawn_blocking;
 
 pub struct Inst {
   pub vt: VtWrap,
+  screen: ScreenWrap,
 
   pub pid: u32,
-  pub master: Box<dyn MasterPty + Send>,
+  pub pty: Pty,
+  #[cfg(windows)]
   pub killer: Box<dyn ChildKiller + Send + Sync>,
 
   pub running: Arc<AtomicBool>,
+  rate: Arc<RateMeter>,
+  backlog: Arc<AtomicUsize>,
 }
 
 impl Debug for Inst {
@@ -39,16 +54,115 @@ impl Debug for Inst {
 
 pub type VtWrap = Arc<RwLock<vt100::Parser>>;
 
+/// Latest published screen snapshot. The lock is only ever held to swap or
+/// clone the inner pointer, so readers never wait on the parser and parsing
+/// never waits on rendering.
+pub type ScreenWrap = Arc<Mutex<Arc<vt100::Screen>>>;
+
 impl Inst {
+  #[cfg(not(windows))]
   fn spawn(
     id: usize,
-    cmd: CommandBuilder,
+    cmd: &CmdSpec,
     tx: UnboundedSender<(usize, ProcUpdate)>,
     size: &Size,
+    scrollback: usize,
+    log: Option<ProcLog>,
+    dirty: Arc<DirtyProcs>,
+    saved: Option<Vec<u8>>,
+    reaper: Arc<Reaper>,
+    scheduler: Arc<ParseScheduler>,
   ) -> anyhow::Result<Self> {
-    let vt = vt100::Parser::new(size.height, size.width, 1000);
+    let mut vt = vt100::Parser::new(size.height, size.width, scrollback);
+    if let Some(saved) = saved {
+      vt.restore_history(&saved);
+    }
+    let screen = Arc::new(Mutex::new(Arc::new(vt.screen().clone())));
     let vt = Arc::new(RwLock::new(vt));
 
+    let mut command = cmd.to_std_command();
+    let (pty, child) = Pty::spawn(&mut command, size.height, size.width)?;
+    let pid = child.id();
+
+    let running = Arc::new(AtomicBool::new(true));
+    let rate = Arc::new(RateMeter::new());
+
+    let reader = pty.reader()?;
+
+    let handle = scheduler.attach(id, vt.clone(), screen.clone(), dirty);
+    let backlog = handle.backlog();
+
+    {
+      let running = running.clone();
+      let rate = rate.clone();
+      tokio::spawn(async move {
+        let mut buf = [0; 4 * 1024];
+        loop {
+          if !running.load(Ordering::Relaxed) {
+            break;
+          }
+
+          match reader.read(&mut buf[..]).await {
+            // Eof or EIO: the child side of the pty is gone.
+            Ok(0) | Err(_) => break,
+            Ok(count) => {
+              if let Some(log) = &log {
+                log.write(&buf[..count]);
+              }
+              rate.add(count);
+              // Blocks while the parse queue is full, which stops
+              // reading and backpressures the pty instead of buffering
+              // a runaway proc's output without limit.
+              if !handle.push(buf[..count].to_vec()).await {
+                break;
+              }
+            }
+          }
+        }
+      });
+    }
+
+    // The shared reaper delivers the exit instead of a dedicated wait
+    // thread per process.
+    reaper.register(pid, id, running.clone(), tx.clone());
+    drop(child);
+
+    let inst = Inst {
+      vt,
+      screen,
+
+      pid,
+      pty,
+
+      running,
+      rate,
+      backlog,
+    };
+    Ok(inst)
+  }
+
+  #[cfg(windows)]
+  fn spawn(
+    id: usize,
+    cmd: &CmdSpec,
+    tx: UnboundedSender<(usize, ProcUpdate)>,
+    size: &Size,
+    scrollback: usize,
+    log: Option<ProcLog>,
+    dirty: Arc<DirtyProcs>,
+    saved: Option<Vec<u8>>,
+    reaper: Arc<Reaper>,
+    scheduler: Arc<ParseScheduler>,
+  ) -> anyhow::Result<Self> {
+    let mut vt = vt100::Parser::new(size.height, size.width, scrollback);
+    if let Some(saved) = saved {
+      vt.restore_history(&saved);
+    }
+    let screen = Arc::new(Mutex::new(Arc::new(vt.screen().clone())));
+    let vt = Arc::new(RwLock::new(vt));
+
+    let cmd = CommandBuilder::from(cmd);
+
     let pty_system = native_pty_system();
     let pair = pty_system.openpty(PtySize {
       rows: size.height,
@@ -58,16 +172,19 @@ impl Inst {
     })?;
 
     let running = Arc::new(AtomicBool::new(true));
+    let rate = Arc::new(RateMeter::new());
     let mut child = pair.slave.spawn_command(cmd)?;
     let pid = child.process_id().unwrap();
     let killer = child.clone_killer();
 
     let mut reader = pair.master.try_clone_reader().unwrap();
 
+    let handle = scheduler.attach(id, vt.clone(), screen.clone(), dirty);
+    let backlog = handle.backlog();
+
     {
-      let tx = tx.clone();
-      let vt = vt.clone();
       let running = running.clone();
+      let rate = rate.clone();
       spawn_blocking(move || {
         let mut buf = [0; 4 * 1024];
         loop {
@@ -78,10 +195,15 @@ impl Inst {
           match reader.read(&mut buf[..]) {
             Ok(count) => {
               if count > 0 {
-                vt.clone().write().unwrap().process(&buf[..count]);
-                match tx.send((id, ProcUpdate::Render)) {
-                  Ok(_) => (),
-                  Err(_) => break,
+                if let Some(log) = &log {
+                  log.write(&buf[..count]);
+                }
+                rate.add(count);
+                // Blocks while the parse queue is full, which stops
+                // reading and backpressures the pty instead of
+                // buffering a runaway proc's output without limit.
+                if !handle.push_blocking(buf[..count].to_vec()) {
+                  break;
                 }
               } else {
                 thread::sleep(Duration::from_millis(10));
@@ -93,44 +215,60 @@ impl Inst {
       });
     }
 
-    {
-      let tx = tx.clone();
-      let running = running.clone();
-      spawn(move || {
-        // Block until program exits
-        let _status = child.wait();
-        running.store(false, Ordering::Relaxed);
-        let _result = tx.send((id, ProcUpdate::Stopped));
-      });
-    }
+    // The shared reaper owns the child handle and delivers the exit
+    // instead of a dedicated wait thread per process.
+    reaper.register(child, id, running.clone(), tx.clone());
 
     let inst = Inst {
       vt,
+      screen,
 
       pid,
-      master: pair.master,
+      pty: Pty::new(pair.master),
       killer,
 
       running,
+      rate,
+      backlog,
     };
     Ok(inst)
   }
 
+  /// Returns the most recently published screen snapshot without touching
+  /// the parser lock.
+  pub fn screen(&self) -> Arc<vt100::Screen> {
+    self.screen.lock().unwrap().clone()
+  }
+
+  /// Output rate in bytes/sec, exponentially decayed so it fades to
+  /// zero once the proc goes quiet.
+  pub fn rate(&self) -> u64 {
+    self.rate.rate()
+  }
+
+  /// Bytes read but not yet parsed: how far the parser is behind this
+  /// proc.
+  pub fn backlog(&self) -> usize {
+    self.backlog.load(Ordering::Relaxed)
+  }
+
+  /// Publishes the current parser state as a new snapshot. Cheap thanks to
+  /// copy-on-write row storage.
+  pub(crate) fn publish_screen(vt: &mut vt100::Parser, screen: &ScreenWrap) {
+    let snapshot = Arc::new(vt.screen().clone());
+    vt.clear_damage();
+    *screen.lock().unwrap() = snapshot;
+  }
+
   fn resize(&self, size: &Size) {
     let rows = size.height;
     let cols = size.width;
 
-    self
-      .master
-      .resize(PtySize {
-        rows,
-        cols,
-        pixel_width: 0,
-        pixel_height: 0,
-      })
-      .unwrap();
+    self.pty.resize(rows, cols).unwrap();
 
-    self.vt.write().unwrap().set_size(rows, cols);
+    let mut vt = self.vt.write().unwrap();
+    vt.set_size(rows, cols);
+    Self::publish_screen(&mut vt, &self.screen);
   }
 }
 
@@ -139,8 +277,9 @@ pub struct Proc {
   pub name: String,
   pub to_restart: bool,
   pub changed: bool,
-  pub cmd: CommandBuilder,
+  pub cmd: CmdSpec,
   size: Size,
+  scrollback: usize,
 
   stop_signal: StopSignal,
 
@@ -148,6 +287,34 @@ pub struct Proc {
 
   pub inst: ProcState,
   pub copy_mode: CopyMode,
+  pub copy_search: Option<CopySearch>,
+
+  /// `autostart: lazy`: spawn on first selection. Cleared once started.
+  lazy: bool,
+
+  /// Input queued by `send_key`/`send_text`, flushed to the pty as a
+  /// single write per burst.
+  input_buf: String,
+
+  /// Tee of raw pty output, shared across restarts so they append to the
+  /// same file.
+  log: Option<ProcLog>,
+
+  /// Shared "needs render" flags, marked by the pty readers.
+  dirty: Arc<DirtyProcs>,
+
+  /// History restored from a session file, consumed by the first spawn.
+  saved_screen: Option<Vec<u8>>,
+
+  /// Shared child reaper that delivers exit notifications.
+  reaper: Arc<Reaper>,
+
+  /// Shared fair-share parser for pty output.
+  scheduler: Arc<ParseScheduler>,
+
+  /// `size` was recorded by `resize_lazy` but not yet applied to the
+  /// pty and grid.
+  needs_resize: bool,
 }
 
 static NEXT_PROC_ID: AtomicUsize = AtomicUsize::new(1);
@@ -155,15 +322,18 @@ static NEXT_PROC_ID: AtomicUsize = AtomicUsize::new(1);
 #[derive(Debug)]
 pub enum ProcState {
   None,
+  /// The pty is being set up on a background task.
+  Starting,
   Some(Inst),
   Error(String),
 }
 
 #[derive(Debug)]
 pub enum ProcUpdate {
-  Render,
   Stopped,
   Started,
+  /// A background spawn finished; carries the pty or the spawn error.
+  Spawned(anyhow::Result<Inst>),
 }
 
 #[derive(Clone, Debug, Deserialize)]
@@ -190,7 +360,11 @@ impl Proc {
     name: String,
     cfg: &ProcConfig,
     tx: UnboundedSender<(usize, ProcUpdate)>,
+    dirty: Arc<DirtyProcs>,
+    reaper: Arc<Reaper>,
+    scheduler: Arc<ParseScheduler>,
     size: Rect,
+    saved_screen: Option<Vec<u8>>,
   ) -> Self {
     let id = NEXT_PROC_ID.fetch_add(1, Ordering::Relaxed);
     let size = Size::new(size);
@@ -201,6 +375,7 @@ impl Proc {
       changed: false,
       cmd: cfg.into(),
       size,
+      scrollback: cfg.scrollback,
 
       stop_signal: cfg.stop.clone(),
 
@@ -208,9 +383,26 @@ impl Proc {
 
       inst: ProcState::None,
       copy_mode: CopyMode::None(None),
+      copy_search: None,
+
+      lazy: cfg.autostart == AutostartConfig::Lazy,
+
+      input_buf: String::with_capacity(1024),
+
+      log: cfg.log.as_ref().map(|path| ProcLog::open(path.clone())),
+
+      dirty,
+
+      saved_screen,
+
+      reaper,
+
+      scheduler,
+
+      needs_resize: false,
     };
 
-    if cfg.autostart {
+    if cfg.autostart == AutostartConfig::Yes {
       proc.spawn_new_inst();
     }
 
@@ -219,25 +411,75 @@ impl Proc {
 
   fn spawn_new_inst(&mut self) {
     assert_matches!(self.inst, ProcState::None);
+    self.inst = ProcState::Starting;
+
+    let id = self.id;
+    let cmd = self.cmd.clone();
+    let tx = self.tx.clone();
+    let size = self.size.clone();
+    let scrollback = self.scrollback;
+    let log = self.log.clone();
+    let dirty = self.dirty.clone();
+    let saved = self.saved_screen.take();
+    let reaper = self.reaper.clone();
+    let scheduler = self.scheduler.clone();
+    // Fan pty setup out to the blocking pool so spawning many autostart
+    // procs runs concurrently instead of serializing in front of the
+    // first frame.
+    tokio::task::spawn_blocking(move || {
+      let spawned = Inst::spawn(
+        id,
+        &cmd,
+        tx.clone(),
+        &size,
+        scrollback,
+        log,
+        dirty,
+        saved,
+        reaper,
+        scheduler,
+      );
+      crate::stats::upd_sent();
+      let _res = tx.send((id, ProcUpdate::Spawned(spawned)));
+    });
+  }
 
-    let spawned =
-      Inst::spawn(self.id, self.cmd.clone(), self.tx.clone(), &self.size);
-    let inst = match spawned {
-      Ok(inst) => ProcState::Some(inst),
+  /// Installs the result of a background spawn, unless the proc left the
+  /// starting state in the meantime.
+  pub fn install_inst(&mut self, spawned: anyhow::Result<Inst>) {
+    if !matches!(self.inst, ProcState::Starting) {
+      return;
+    }
+    self.inst = match spawned {
+      Ok(inst) => {
+        // The terminal may have been resized while the pty was being set
+        // up.
+        inst.resize(&self.size);
+        self.needs_resize = false;
+        ProcState::Some(inst)
+      }
       Err(err) => ProcState::Error(err.to_string()),
     };
-    self.inst = inst;
   }
 
   pub fn start(&mut self) {
-    if !self.is_up() {
+    self.lazy = false;
+    if !self.is_up() && !matches!(self.inst, ProcState::Starting) {
       self.inst = ProcState::None;
       self.spawn_new_inst();
 
+      crate::stats::upd_sent();
       let _res = self.tx.send((self.id, ProcUpdate::Started));
     }
   }
 
+  /// Starts an `autostart: lazy` proc the first time it is selected.
+  pub fn start_if_lazy(&mut self) {
+    if self.lazy {
+      self.start();
+    }
+  }
+
   pub fn is_up(&self) -> bool {
     if let ProcState::Some(inst) = &self.inst {
       inst.running.load(Ordering::Relaxed)
@@ -246,6 +488,16 @@ impl Proc {
     }
   }
 
+  #[cfg(not(windows))]
+  pub fn kill(&mut self) {
+    if self.is_up() {
+      // Same as the hard kill in portable-pty: the default disposition of
+      // SIGHUP is to terminate the process.
+      self.send_signal(libc::SIGHUP);
+    }
+  }
+
+  #[cfg(windows)]
   pub fn kill(&mut self) {
     if self.is_up() {
       if let ProcState::Some(inst) = &mut self.inst {
@@ -264,6 +516,7 @@ impl Proc {
         for key in keys {
           self.send_key(&key);
         }
+        self.flush_input();
       }
       StopSignal::HardKill => self.kill(),
     }
@@ -279,6 +532,7 @@ impl Proc {
         for key in keys {
           self.send_key(&key);
         }
+        self.flush_input();
       }
       StopSignal::HardKill => self.kill(),
     }
@@ -293,59 +547,110 @@ impl Proc {
 
   pub fn resize(&mut self, size: Rect) {
     let size = Size::new(size);
+    if size == self.size && !self.needs_resize {
+      return;
+    }
     if let ProcState::Some(inst) = &self.inst {
       inst.resize(&size);
     }
     self.size = size;
+    self.needs_resize = false;
+  }
+
+  /// Records the size without reflowing the grid; the pty and grid
+  /// catch up via `sync_size` when the proc is next visible. Reflowing
+  /// a large scrollback is expensive, so procs in the background skip
+  /// the intermediate sizes of a resize storm entirely.
+  pub fn resize_lazy(&mut self, size: Rect) {
+    let size = Size::new(size);
+    if size == self.size {
+      return;
+    }
+    self.size = size;
+    self.needs_resize = true;
   }
 
+  /// Applies a resize deferred by `resize_lazy`.
+  pub fn sync_size(&mut self) {
+    if self.needs_resize {
+      self.needs_resize = false;
+      if let ProcState::Some(inst) = &self.inst {
+        inst.resize(&self.size);
+      }
+    }
+  }
+
+  /// Queues the encoded key. Nothing reaches the pty until
+  /// `flush_input`, so a burst of keys becomes a single write.
   pub fn send_key(&mut self, key: &Key) {
     if self.is_up() {
       let application_cursor_keys = match &self.inst {
-        ProcState::None => unreachable!(),
-        ProcState::Some(inst) => {
-          inst.vt.read().unwrap().screen().application_cursor()
-        }
+        ProcState::None | ProcState::Starting => unreachable!(),
+        ProcState::Some(inst) => inst.screen().application_cursor(),
         ProcState::Error(_) => unreachable!(),
       };
-      let encoder = encode_key(
+      let len = self.input_buf.len();
+      let encoded = encode_key(
         key,
         KeyCodeEncodeModes {
           enable_csi_u_key_encoding: false,
           application_cursor_keys,
           newline_mode: false,
         },
+        &mut self.input_buf,
       );
-      match encoder {
-        Ok(encoder) => {
-          self.write_all(encoder.as_bytes());
-        }
-        Err(_) => {
-          log::warn!("Failed to encode key: {}", key.to_string());
-        }
+      if encoded.is_err() {
+        self.input_buf.truncate(len);
+        log::warn!("Failed to encode key: {}", key.to_string());
       }
     }
   }
 
-  pub fn write_all(&mut self, bytes: &[u8]) {
+  /// Queues literal text, wrapped in bracketed paste markers when the
+  /// child has that mode on, so a paste arrives as one block instead of
+  /// a replay of individual keys.
+  pub fn send_text(&mut self, text: &str) {
+    if self.is_up() {
+      let bracketed = match &self.inst {
+        ProcState::Some(inst) => inst.screen().bracketed_paste(),
+        _ => unreachable!(),
+      };
+      if bracketed {
+        self.input_buf.push_str("\x1b[200~");
+        self.input_buf.push_str(text);
+        self.input_buf.push_str("\x1b[201~");
+      } else {
+        self.input_buf.push_str(text);
+      }
+    }
+  }
+
+  /// Flushes everything queued since the last flush to the pty as one
+  /// write. No-op when nothing is queued.
+  pub fn flush_input(&mut self) {
+    if self.input_buf.is_empty() {
+      return;
+    }
     if self.is_up() {
       if let ProcState::Some(inst) = &mut self.inst {
         {
           let mut vt = inst.vt.write().unwrap();
           if vt.screen().scrollback() > 0 {
             vt.set_scrollback(0);
+            Inst::publish_screen(&mut vt, &inst.screen);
           }
         }
-        inst.master.write_all(bytes).unwrap();
+        inst.pty.write_all(self.input_buf.as_bytes()).unwrap();
       }
     }
+    self.input_buf.clear();
   }
 
   pub fn scroll_up_lines(&mut self, n: usize) {
     match &mut self.copy_mode {
       CopyMode::None(_) => {
         if let ProcState::Some(inst) = &mut self.inst {
-          Self::scroll_vt_up(&mut inst.vt.write().unwrap(), n);
+          Self::scroll_vt_up(inst, n);
         }
       }
       CopyMode::Start(screen, _) | CopyMode::Range(screen, _, _) => {
@@ -354,9 +659,11 @@ impl Proc {
     }
   }
 
-  fn scroll_vt_up(vt: &mut vt100::Parser, n: usize) {
+  fn scroll_vt_up(inst: &Inst, n: usize) {
+    let mut vt = inst.vt.write().unwrap();
     let pos = usize::saturating_add(vt.screen().scrollback(), n);
     vt.set_scrollback(pos);
+    Inst::publish_screen(&mut vt, &inst.screen);
   }
 
   fn scroll_screen_up(screen: &mut vt100::Screen, n: usize) {
@@ -368,7 +675,7 @@ impl Proc {
     match &mut self.copy_mode {
       CopyMode::None(_) => {
         if let ProcState::Some(inst) = &mut self.inst {
-          Self::scroll_vt_down(&mut inst.vt.write().unwrap(), n);
+          Self::scroll_vt_down(inst, n);
         }
       }
       CopyMode::Start(screen, _) | CopyMode::Range(screen, _, _) => {
@@ -377,9 +684,11 @@ impl Proc {
     }
   }
 
-  fn scroll_vt_down(vt: &mut vt100::Parser, n: usize) {
+  fn scroll_vt_down(inst: &Inst, n: usize) {
+    let mut vt = inst.vt.write().unwrap();
     let pos = usize::saturating_sub(vt.screen().scrollback(), n);
     vt.set_scrollback(pos);
+    Inst::publish_screen(&mut vt, &inst.screen);
   }
 
   fn scroll_screen_down(screen: &mut vt100::Screen, n: usize) {
@@ -395,6 +704,117 @@ impl Proc {
     self.scroll_down_lines(self.size.height as usize / 2);
   }
 
+  /// Ensures a search index exists for the current copy mode session.
+  /// Row text is extracted once from the frozen snapshot, so later
+  /// queries and match jumps never rescan cell storage. Returns false
+  /// outside of copy mode.
+  pub fn search_open(&mut self) -> bool {
+    let screen = match &self.copy_mode {
+      CopyMode::None(_) => return false,
+      CopyMode::Start(screen, _) | CopyMode::Range(screen, _, _) => screen,
+    };
+    if self.copy_search.is_none() {
+      let index = screen.row_texts();
+      let top = index.len().saturating_sub(screen.size().0 as usize) as i32;
+      self.copy_search = Some(CopySearch {
+        query: String::new(),
+        len: 0,
+        index,
+        top,
+        matches: Vec::new(),
+        current: 0,
+      });
+    }
+    true
+  }
+
+  /// Recomputes matches for `query` against the prebuilt index and jumps
+  /// to the closest match at or after the cursor.
+  pub fn search_update(&mut self, query: &str) {
+    let cursor = match &self.copy_mode {
+      CopyMode::None(_) => return,
+      CopyMode::Start(_, pos) | CopyMode::Range(_, _, pos) => pos.clone(),
+    };
+    let search = match &mut self.copy_search {
+      Some(search) => search,
+      None => return,
+    };
+
+    search.query = query.to_string();
+    search.len = query.width();
+    search.matches.clear();
+    if !query.is_empty() {
+      for (i, line) in search.index.iter().enumerate() {
+        let y = i as i32 - search.top;
+        let mut from = 0;
+        while let Some(found) = line[from..].find(query) {
+          // `Pos.x` is a terminal cell column, and the row text packs
+          // wide chars into one char and combining marks into extra
+          // chars, so the prefix is measured in display width
+          let x = line[..from + found].width() as i32;
+          search.matches.push(Pos { y, x });
+          from += found + query.len();
+        }
+      }
+    }
+    search.current = search
+      .matches
+      .iter()
+      .position(|m| (m.y, m.x) >= (cursor.y, cursor.x))
+      .unwrap_or(0);
+    self.search_jump();
+  }
+
+  pub fn search_next(&mut self) {
+    if let Some(search) = &mut self.copy_search {
+      if !search.matches.is_empty() {
+        search.current = (search.current + 1) % search.matches.len();
+      }
+    }
+    self.search_jump();
+  }
+
+  pub fn search_prev(&mut self) {
+    if let Some(search) = &mut self.copy_search {
+      if !search.matches.is_empty() {
+        search.current = search
+          .current
+          .checked_sub(1)
+          .unwrap_or(search.matches.len() - 1);
+      }
+    }
+    self.search_jump();
+  }
+
+  pub fn search_cancel(&mut self) {
+    self.copy_search = None;
+  }
+
+  /// Moves the copy mode cursor to the current match and scrolls it into
+  /// view.
+  fn search_jump(&mut self) {
+    let target = match &self.copy_search {
+      Some(search) => match search.matches.get(search.current) {
+        Some(pos) => pos.clone(),
+        None => return,
+      },
+      None => return,
+    };
+    match &mut self.copy_mode {
+      CopyMode::None(_) => (),
+      CopyMode::Start(screen, pos) | CopyMode::Range(screen, _, pos) => {
+        let rows = screen.size().0 as i32;
+        let offset = screen.scrollback() as i32;
+        if target.y < -offset {
+          screen.set_scrollback((-target.y) as usize);
+        } else if target.y >= rows - offset {
+          screen.set_scrollback((rows - 1 - target.y).max(0) as usize);
+        }
+        *pos = target;
+      }
+    }
+  }
+
   pub fn handle_mouse(
     &mut self,
     event: MouseEvent,
@@ -419,6 +839,7 @@ impl Proc {
             self.copy_mode = CopyMode::None(Some(translate_mouse_pos(
               &event, &term_area, scrollback,
             )));
+            self.copy_search = None;
           }
           MouseButton::Right => {
             self.copy_mode = match std::mem::take(&mut self.copy_mode) {
@@ -462,31 +883,27 @@ impl Proc {
       }
     } else {
       if let ProcState::Some(inst) = &mut self.inst {
-        let mouse_mode = inst.vt.read().unwrap().screen().mouse_protocol_mode();
+        let mouse_mode = inst.screen().mouse_protocol_mode();
         match mouse_mode {
           MouseProtocolMode::None => match event.kind {
             MouseEventKind::Down(btn) => match btn {
               MouseButton::Left => {
-                let vt = inst.vt.read().unwrap();
                 self.copy_mode = CopyMode::None(Some(translate_mouse_pos(
                   &event,
                   &term_area,
-                  vt.screen().scrollback(),
+                  inst.screen().scrollback(),
                 )));
               }
               MouseButton::Right | MouseButton::Middle => (),
             },
             MouseEventKind::Up(_) => (),
             MouseEventKind::Drag(MouseButton::Left) => {
-              let vt = inst.vt.read().unwrap();
-              let pos = translate_mouse_pos(
-                &event,
-                &term_area,
-                vt.screen().scrollback(),
-              );
+              let screen = inst.screen();
+              let pos =
+                translate_mouse_pos(&event, &term_area, screen.scrollback());
               self.copy_mode = match std::mem::take(&mut self.copy_mode) {
                 CopyMode::None(pos_) => CopyMode::Range(
-                  vt.screen().clone(),
+                  (*screen).clone(),
                   pos_.unwrap_or_default(),
                   pos,
                 ),
@@ -498,16 +915,10 @@ impl Proc {
             MouseEventKind::Drag(_) => (),
             MouseEventKind::Moved => (),
             MouseEventKind::ScrollDown => {
-              Self::scroll_vt_down(
-                &mut inst.vt.write().unwrap(),
-                config.mouse_scroll_speed,
-              );
+              Self::scroll_vt_down(inst, config.mouse_scroll_speed);
             }
             MouseEventKind::ScrollUp => {
-              Self::scroll_vt_up(
-                &mut inst.vt.write().unwrap(),
-                config.mouse_scroll_speed,
-              );
+              Self::scroll_vt_up(inst, config.mouse_scroll_speed);
             }
           },
           MouseProtocolMode::Press
@@ -521,7 +932,7 @@ impl Proc {
               modifiers: event.modifiers,
             };
             let seq = encode_mouse_event(ev);
-            let _r = inst.master.write_all(seq.as_bytes());
+            self.input_buf.push_str(&seq);
           }
         }
       }
@@ -539,6 +950,7 @@ fn translate_mouse_pos(
   Pos { y, x }
 }
 
+#[derive(Clone, Eq, PartialEq)]
 struct Size {
   width: u16,
   height: u16,
@@ -565,6 +977,19 @@ impl Default for CopyMode {
   }
 }
 
+/// Search state for a copy mode session: row text extracted once into a
+/// compact index, plus the match positions for the current query.
+pub struct CopySearch {
+  pub query: String,
+  /// Match width in terminal cells (the query's display width).
+  pub len: usize,
+  index: Vec<String>,
+  /// Number of scrollback rows in the index; entry `i` is row `i - top`.
+  top: i32,
+  pub matches: Vec<Pos>,
+  pub current: usize,
+}
+
 #[derive(
   Clone, Debug, Default, Deserialize, Eq, Hash, PartialEq, Serialize,
 )]
@@ -0,0 +1,116 @@
+use std::path::PathBuf;
+
+use tokio::{
+  fs::{self, File, OpenOptions},
+  io::AsyncWriteExt,
+  sync::mpsc::{unbounded_channel, UnboundedReceiver, UnboundedSender},
+  time::{interval, Duration, MissedTickBehavior},
+};
+
+/// Bytes buffered before a write is forced, so a fast proc is logged in
+/// large sequential appends.
+const FLUSH_BYTES: usize = 64 * 1024;
+/// How often buffered bytes are written out regardless of volume.
+const FLUSH_INTERVAL: Duration = Duration::from_millis(500);
+/// When the log grows past this size it is rotated to `<path>.1`,
+/// replacing the previous rotation.
+const ROTATE_BYTES: u64 = 16 * 1024 * 1024;
+
+/// Tees raw pty output into a log file through a dedicated writer task.
+///
+/// `write` only queues the bytes, so the pty reader loop never waits on
+/// disk. The task batches queued chunks into large appends, flushes
+/// periodically, and rotates the file by size. The task exits (after a
+/// final flush) when the last handle is dropped.
+#[derive(Clone, Debug)]
+pub struct ProcLog {
+  tx: UnboundedSender<Vec<u8>>,
+}
+
+impl ProcLog {
+  pub fn open(path: PathBuf) -> Self {
+    let (tx, rx) = unbounded_channel();
+    tokio::spawn(async move {
+      if let Err(err) = run_writer(&path, rx).await {
+        log::warn!("Failed to write log {:?}: {}", path, err);
+      }
+    });
+    ProcLog { tx }
+  }
+
+  pub fn write(&self, bytes: &[u8]) {
+    let _res = self.tx.send(bytes.to_vec());
+  }
+}
+
+async fn run_writer(
+  path: &PathBuf,
+  mut rx: UnboundedReceiver<Vec<u8>>,
+) -> std::io::Result<()> {
+  let mut file = open_log(path).await?;
+  let mut written = file.metadata().await?.len();
+  let mut buf: Vec<u8> = Vec::with_capacity(FLUSH_BYTES);
+
+  let mut tick = interval(FLUSH_INTERVAL);
+  tick.set_missed_tick_behavior(MissedTickBehavior::Delay);
+
+  loop {
+    tokio::select! {
+      chunk = rx.recv() => match chunk {
+        Some(chunk) => {
+          buf.extend_from_slice(&chunk);
+          // Drain whatever else is already queued, but keep batches near
+          // FLUSH_BYTES so the rotation size check runs often enough.
+          while buf.len() < FLUSH_BYTES {
+            match rx.try_recv() {
+              Ok(chunk) => buf.extend_from_slice(&chunk),
+              Err(_) => break,
+            }
+          }
+          if buf.len() >= FLUSH_BYTES {
+            written = flush(path, &mut file, &mut buf, written).await?;
+          }
+        }
+        None => {
+          flush(path, &mut file, &mut buf, written).await?;
+          return Ok(());
+        }
+      },
+      _ = tick.tick() => {
+        if !buf.is_empty() {
+          written = flush(path, &mut file, &mut buf, written).await?;
+        }
+      }
+    }
+  }
+}
+
+async fn flush(
+  path: &PathBuf,
+  file: &mut File,
+  buf: &mut Vec<u8>,
+  written: u64,
+) -> std::io::Result<u64> {
+  file.write_all(buf).await?;
+  file.flush().await?;
+  let mut written = written + buf.len() as u64;
+  buf.clear();
+
+  if written >= ROTATE_BYTES {
+    let mut rotated = path.clone().into_os_string();
+    rotated.push(".1");
+    fs::rename(path, rotated).await?;
+    *file = open_log(path).await?;
+    written = 0;
+  }
+
+  Ok(written)
+}
+
+async fn open_log(path: &PathBuf) -> std::io::Result<File> {
+  OpenOptions::new()
+    .create(true)
+    .append(true)
+    .open(path)
+    .await
+}
@@ -0,0 +1,43 @@
+//! Opt-in tracing spans on the hot paths (`--features profiling`).
+//!
+//! Built with the `profiling` feature, [`prof_span!`] opens a `tracing`
+//! span for the rest of the enclosing scope and a chrome-trace file
+//! (`mprocs-trace-<pid>.json`, loadable in `chrome://tracing`, Perfetto
+//! or speedscope) is written out when mprocs exits. Without the feature
+//! the macro expands to nothing and none of the tracing crates are
+//! compiled in.
+
+/// Starts the chrome-trace writer. The returned guard flushes the trace
+/// file when dropped, so it must live for the whole run.
+#[cfg(feature = "profiling")]
+pub fn init() -> impl Drop {
+  use tracing_subscriber::prelude::*;
+
+  let (layer, guard) = tracing_chrome::ChromeLayerBuilder::new()
+    .file(format!("mprocs-trace-{}.json", std::process::id()))
+    .build();
+  // `init` would also claim the `log` crate's global logger, which
+  // flexi_logger already owns; setting only the tracing default leaves
+  // normal logging alone.
+  tracing::subscriber::set_global_default(
+    tracing_subscriber::registry().with(layer),
+  )
+  .expect("failed to set tracing subscriber");
+  guard
+}
+
+/// Opens a span covering the rest of the enclosing scope.
+#[cfg(feature = "profiling")]
+#[macro_export]
+macro_rules! prof_span {
+  ($name:expr) => {
+    let _prof_span = tracing::info_span!($name).entered();
+  };
+}
+
+/// Expands to nothing without the `profiling` feature.
+#[cfg(not(feature = "profiling"))]
+#[macro_export]
+macro_rules! prof_span {
+  ($name:expr) => {};
+}
@@ -0,0 +1,290 @@
+//! Pseudoterminal plumbing.
+//!
+//! On unix the pty is opened directly and the master fd is registered with
+//! the tokio reactor, so output from every process is multiplexed through
+//! the runtime's epoll/kqueue driver. Thread count and idle cpu usage stay
+//! flat no matter how many processes are running. On windows ptys are
+//! provided by portable-pty and are still read by a blocking thread each.
+
+#[cfg(not(windows))]
+pub use self::unix::Pty;
+#[cfg(windows)]
+pub use self::windows::Pty;
+
+#[cfg(not(windows))]
+mod unix {
+  use std::io;
+  use std::os::unix::io::{AsRawFd, FromRawFd, RawFd};
+  use std::os::unix::process::CommandExt;
+  use std::process::{Child, Command, Stdio};
+  use std::ptr;
+
+  use tokio::io::unix::AsyncFd;
+
+  /// An owned fd that is closed on drop.
+  struct Fd(RawFd);
+
+  impl Drop for Fd {
+    fn drop(&mut self) {
+      unsafe { libc::close(self.0) };
+    }
+  }
+
+  impl AsRawFd for Fd {
+    fn as_raw_fd(&self) -> RawFd {
+      self.0
+    }
+  }
+
+  /// Master side of a pty.
+  pub struct Pty {
+    master: Fd,
+  }
+
+  impl Pty {
+    /// Opens a pty of the given size and spawns `cmd` attached to the
+    /// slave side.
+    pub fn spawn(
+      cmd: &mut Command,
+      rows: u16,
+      cols: u16,
+    ) -> anyhow::Result<(Self, Child)> {
+      let (master, slave) = openpty(rows, cols)?;
+      let master = Fd(master);
+      let slave = Fd(slave);
+
+      cloexec(master.0)?;
+      cloexec(slave.0)?;
+      // The master is read through the reactor, so it must never block the
+      // runtime worker threads.
+      set_nonblocking(master.0)?;
+
+      cmd
+        .stdin(slave_stdio(&slave)?)
+        .stdout(slave_stdio(&slave)?)
+        .stderr(slave_stdio(&slave)?);
+      unsafe {
+        cmd.pre_exec(|| {
+          // Reset signal dispositions that may have been inherited from
+          // mprocs.
+          for signo in [
+            libc::SIGCHLD,
+            libc::SIGHUP,
+            libc::SIGINT,
+            libc::SIGQUIT,
+            libc::SIGTERM,
+            libc::SIGALRM,
+          ] {
+            libc::signal(signo, libc::SIG_DFL);
+          }
+
+          if libc::setsid() == -1 {
+            return Err(io::Error::last_os_error());
+          }
+
+          // Make the pty the controlling terminal so that the child
+          // receives SIGWINCH on resize.
+          if libc::ioctl(0, libc::TIOCSCTTY as _, 0) == -1 {
+            return Err(io::Error::last_os_error());
+          }
+
+          Ok(())
+        });
+      }
+
+      let mut child = cmd.spawn()?;
+      // Drop all slave fds on our side, otherwise reads from the master
+      // would never report eof after the child exits.
+      child.stdin.take();
+      child.stdout.take();
+      child.stderr.take();
+      drop(slave);
+
+      Ok((Pty { master }, child))
+    }
+
+    /// Returns a reader for the process output registered with the tokio
+    /// reactor.
+    pub fn reader(&self) -> io::Result<PtyReader> {
+      let fd = Fd(dup(self.master.0)?);
+      Ok(PtyReader {
+        fd: AsyncFd::new(fd)?,
+      })
+    }
+
+    pub fn resize(&self, rows: u16, cols: u16) -> anyhow::Result<()> {
+      let size = libc::winsize {
+        ws_row: rows,
+        ws_col: cols,
+        ws_xpixel: 0,
+        ws_ypixel: 0,
+      };
+      if unsafe { libc::ioctl(self.master.0, libc::TIOCSWINSZ, &size) } != 0 {
+        return Err(io::Error::last_os_error().into());
+      }
+      Ok(())
+    }
+
+    pub fn write_all(&mut self, mut buf: &[u8]) -> io::Result<()> {
+      while !buf.is_empty() {
+        let count = unsafe {
+          libc::write(self.master.0, buf.as_ptr().cast(), buf.len())
+        };
+        if count < 0 {
+          let err = io::Error::last_os_error();
+          match err.kind() {
+            io::ErrorKind::WouldBlock => wait_writable(self.master.0)?,
+            io::ErrorKind::Interrupted => (),
+            _ => return Err(err),
+          }
+        } else {
+          buf = &buf[count as usize..];
+        }
+      }
+      Ok(())
+    }
+  }
+
+  /// Async reader for the master side of a pty.
+  pub struct PtyReader {
+    fd: AsyncFd<Fd>,
+  }
+
+  impl PtyReader {
+    /// Reads available process output, suspending on the reactor while
+    /// there is none. Returns `Ok(0)` or an error when the child side of
+    /// the pty is gone.
+    pub async fn read(&self, buf: &mut [u8]) -> io::Result<usize> {
+      loop {
+        let mut guard = self.fd.readable().await?;
+        let result = guard.try_io(|fd| {
+          let count = unsafe {
+            libc::read(fd.get_ref().0, buf.as_mut_ptr().cast(), buf.len())
+          };
+          if count < 0 {
+            Err(io::Error::last_os_error())
+          } else {
+            Ok(count as usize)
+          }
+        });
+        match result {
+          Ok(result) => return result,
+          // Spurious wakeup, wait for readiness again.
+          Err(_would_block) => (),
+        }
+      }
+    }
+  }
+
+  fn openpty(rows: u16, cols: u16) -> io::Result<(RawFd, RawFd)> {
+    let mut master: RawFd = -1;
+    let mut slave: RawFd = -1;
+    let mut size = libc::winsize {
+      ws_row: rows,
+      ws_col: cols,
+      ws_xpixel: 0,
+      ws_ypixel: 0,
+    };
+    let result = unsafe {
+      libc::openpty(
+        &mut master,
+        &mut slave,
+        ptr::null_mut(),
+        ptr::null_mut(),
+        &mut size,
+      )
+    };
+    if result != 0 {
+      return Err(io::Error::last_os_error());
+    }
+    Ok((master, slave))
+  }
+
+  fn slave_stdio(slave: &Fd) -> io::Result<Stdio> {
+    let fd = dup(slave.0)?;
+    Ok(unsafe { Stdio::from_raw_fd(fd) })
+  }
+
+  fn dup(fd: RawFd) -> io::Result<RawFd> {
+    let fd = unsafe { libc::dup(fd) };
+    if fd == -1 {
+      return Err(io::Error::last_os_error());
+    }
+    Ok(fd)
+  }
+
+  fn cloexec(fd: RawFd) -> io::Result<()> {
+    let flags = unsafe { libc::fcntl(fd, libc::F_GETFD) };
+    if flags == -1 {
+      return Err(io::Error::last_os_error());
+    }
+    let result =
+      unsafe { libc::fcntl(fd, libc::F_SETFD, flags | libc::FD_CLOEXEC) };
+    if result == -1 {
+      return Err(io::Error::last_os_error());
+    }
+    Ok(())
+  }
+
+  fn set_nonblocking(fd: RawFd) -> io::Result<()> {
+    let flags = unsafe { libc::fcntl(fd, libc::F_GETFL) };
+    if flags == -1 {
+      return Err(io::Error::last_os_error());
+    }
+    let result =
+      unsafe { libc::fcntl(fd, libc::F_SETFL, flags | libc::O_NONBLOCK) };
+    if result == -1 {
+      return Err(io::Error::last_os_error());
+    }
+    Ok(())
+  }
+
+  fn wait_writable(fd: RawFd) -> io::Result<()> {
+    let mut pfd = libc::pollfd {
+      fd,
+      events: libc::POLLOUT,
+      revents: 0,
+    };
+    loop {
+      let result = unsafe { libc::poll(&mut pfd, 1, -1) };
+      if result >= 0 {
+        return Ok(());
+      }
+      let err = io::Error::last_os_error();
+      if err.kind() != io::ErrorKind::Interrupted {
+        return Err(err);
+      }
+    }
+  }
+}
+
+#[cfg(windows)]
+mod windows {
+  use std::io;
+
+  use portable_pty::{MasterPty, PtySize};
+
+  /// Master side of a pty.
+  pub struct Pty {
+    master: Box<dyn MasterPty + Send>,
+  }
+
+  impl Pty {
+    pub fn new(master: Box<dyn MasterPty + Send>) -> Self {
+      Pty { master }
+    }
+
+    pub fn resize(&self, rows: u16, cols: u16) -> anyhow::Result<()> {
+      self.master.resize(PtySize {
+        rows,
+        cols,
+        pixel_width: 0,
+        pixel_height: 0,
+      })
+    }
+
+    pub fn write_all(&mut self, buf: &[u8]) -> io::Result<()> {
+      self.master.write_all(buf)
+    }
+  }
+}
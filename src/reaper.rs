@@ -0,0 +1,213 @@
+//! Child exit notifications without a wait thread per process.
+//!
+//! Every spawned process used to park a dedicated OS thread in
+//! `child.wait()` just to flip its `running` flag. The reaper replaces
+//! them: on unix a single task waits for SIGCHLD and drains `waitpid`,
+//! on windows a single thread polls the registered child handles. Thread
+//! count stays constant as the process list grows.
+
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
+
+use tokio::sync::mpsc::UnboundedSender;
+
+use crate::proc::ProcUpdate;
+
+/// What to do once a registered child exits: mirrors the tail of the old
+/// per-process wait thread.
+struct Entry {
+  id: usize,
+  running: Arc<AtomicBool>,
+  tx: UnboundedSender<(usize, ProcUpdate)>,
+}
+
+impl Entry {
+  fn finish(self) {
+    self.running.store(false, Ordering::Relaxed);
+    crate::stats::upd_sent();
+    let _result = self.tx.send((self.id, ProcUpdate::Stopped));
+  }
+}
+
+#[cfg(not(windows))]
+pub use self::unix::Reaper;
+#[cfg(windows)]
+pub use self::windows::Reaper;
+
+#[cfg(not(windows))]
+mod unix {
+  use std::collections::{HashMap, HashSet};
+  use std::sync::atomic::AtomicBool;
+  use std::sync::{Arc, Mutex};
+
+  use tokio::signal::unix::{signal, SignalKind};
+  use tokio::sync::mpsc::UnboundedSender;
+
+  use super::Entry;
+  use crate::proc::ProcUpdate;
+
+  #[derive(Default)]
+  struct Table {
+    entries: HashMap<libc::pid_t, Entry>,
+    /// Pids reaped before `register` was called for them: a child can
+    /// exit between `spawn` and registration, so the exit is stashed
+    /// here and delivered when the registration arrives.
+    unclaimed: HashSet<libc::pid_t>,
+  }
+
+  /// SIGCHLD-driven reaper. Must be created on the runtime before the
+  /// first process is spawned so no exit predates the signal listener.
+  pub struct Reaper {
+    table: Arc<Mutex<Table>>,
+  }
+
+  impl Reaper {
+    pub fn new() -> Self {
+      let table: Arc<Mutex<Table>> = Arc::new(Mutex::new(Table::default()));
+
+      let task_table = table.clone();
+      tokio::spawn(async move {
+        let mut sigchld = match signal(SignalKind::child()) {
+          Ok(sigchld) => sigchld,
+          Err(err) => {
+            log::warn!("Failed to listen for SIGCHLD: {}", err);
+            return;
+          }
+        };
+        while sigchld.recv().await.is_some() {
+          // One signal can stand for any number of exited children.
+          loop {
+            let mut status = 0;
+            let pid = unsafe { libc::waitpid(-1, &mut status, libc::WNOHANG) };
+            if pid <= 0 {
+              break;
+            }
+            let entry = {
+              let mut table = task_table.lock().unwrap();
+              let entry = table.entries.remove(&pid);
+              if entry.is_none() {
+                table.unclaimed.insert(pid);
+              }
+              entry
+            };
+            if let Some(entry) = entry {
+              entry.finish();
+            }
+          }
+        }
+      });
+
+      Reaper { table }
+    }
+
+    /// Registers a spawned child. The exit notification is delivered
+    /// through `tx` as `ProcUpdate::Stopped`, exactly like the old wait
+    /// thread did.
+    pub fn register(
+      &self,
+      pid: u32,
+      id: usize,
+      running: Arc<AtomicBool>,
+      tx: UnboundedSender<(usize, ProcUpdate)>,
+    ) {
+      let pid = pid as libc::pid_t;
+      let entry = Entry { id, running, tx };
+      // Checking the stash and inserting must happen under one lock,
+      // otherwise an exit arriving in between would be lost.
+      let already_exited = {
+        let mut table = self.table.lock().unwrap();
+        if table.unclaimed.remove(&pid) {
+          Some(entry)
+        } else {
+          table.entries.insert(pid, entry);
+          None
+        }
+      };
+      if let Some(entry) = already_exited {
+        entry.finish();
+      }
+    }
+  }
+}
+
+#[cfg(windows)]
+mod windows {
+  use std::sync::atomic::AtomicBool;
+  use std::sync::mpsc::{channel, Sender};
+  use std::sync::Arc;
+  use std::thread;
+  use std::time::Duration;
+
+  use tokio::sync::mpsc::UnboundedSender;
+
+  use super::Entry;
+  use crate::proc::ProcUpdate;
+
+  /// How often the registered children are polled for exit, matching the
+  /// cadence of the windows pty reader.
+  const POLL_INTERVAL: Duration = Duration::from_millis(10);
+
+  struct Registration {
+    child: Box<dyn portable_pty::Child + Send>,
+    entry: Entry,
+  }
+
+  /// Single polling thread owning every child handle. It blocks on the
+  /// registration channel while no children are alive.
+  pub struct Reaper {
+    reg_tx: Sender<Registration>,
+  }
+
+  impl Reaper {
+    pub fn new() -> Self {
+      let (reg_tx, reg_rx) = channel::<Registration>();
+
+      thread::spawn(move || {
+        let mut children: Vec<Registration> = Vec::new();
+        loop {
+          if children.is_empty() {
+            match reg_rx.recv() {
+              Ok(reg) => children.push(reg),
+              // All handles are gone: mprocs is quitting.
+              Err(_) => return,
+            }
+          }
+          while let Ok(reg) = reg_rx.try_recv() {
+            children.push(reg);
+          }
+
+          let mut i = 0;
+          while i < children.len() {
+            let done = match children[i].child.try_wait() {
+              Ok(None) => false,
+              Ok(Some(_)) | Err(_) => true,
+            };
+            if done {
+              children.swap_remove(i).entry.finish();
+            } else {
+              i += 1;
+            }
+          }
+
+          thread::sleep(POLL_INTERVAL);
+        }
+      });
+
+      Reaper { reg_tx }
+    }
+
+    /// Registers a spawned child. The reaper takes ownership of the
+    /// handle and delivers the exit through `tx` as
+    /// `ProcUpdate::Stopped`, exactly like the old wait thread did.
+    pub fn register(
+      &self,
+      child: Box<dyn portable_pty::Child + Send>,
+      id: usize,
+      running: Arc<AtomicBool>,
+      tx: UnboundedSender<(usize, ProcUpdate)>,
+    ) {
+      let entry = Entry { id, running, tx };
+      let _result = self.reg_tx.send(Registration { child, entry });
+    }
+  }
+}
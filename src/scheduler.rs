@@ -0,0 +1,222 @@
+//! Fair-share parsing of pty output.
+//!
+//! Each proc's reader used to parse chunks inline as fast as `read`
+//! returned them, so one proc dumping megabytes per second could hold a
+//! runtime worker while quieter procs' output waited behind it. The
+//! scheduler owns the parsing stage instead: readers queue raw chunks,
+//! and a single task walks the procs round-robin, parsing at most a
+//! quantum of bytes per proc per round. A runaway log can then delay
+//! another proc's output by at most one round, not indefinitely.
+//!
+//! The per-proc queue is bounded. When a parser falls behind, the
+//! reader's send blocks, reading stops, and the kernel pty buffer fills
+//! until the child's writes block: the child sees backpressure instead
+//! of mprocs buffering its output without limit. The number of bytes
+//! sitting in a queue is tracked so the stats pane can show which proc
+//! is hogging the parser.
+
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Arc;
+
+use tokio::sync::mpsc::error::TryRecvError;
+use tokio::sync::mpsc::{channel, unbounded_channel, Receiver, Sender};
+use tokio::sync::mpsc::{UnboundedReceiver, UnboundedSender};
+use tokio::sync::Notify;
+
+use crate::dirty::DirtyProcs;
+use crate::proc::{Inst, ScreenWrap, VtWrap};
+
+/// Most bytes parsed for one proc in one round.
+const QUANTUM: usize = 64 * 1024;
+
+/// Chunks a reader may queue before its send blocks. Readers hand over
+/// chunks of at most 4 KiB, so this caps a proc's backlog near 64 KiB.
+const QUEUE_CHUNKS: usize = 16;
+
+/// Handle a pty reader pushes its chunks through. Dropping it (the
+/// reader loop ending) detaches the proc from the scheduler once its
+/// queue drains.
+pub struct ParseHandle {
+  tx: Sender<Vec<u8>>,
+  notify: Arc<Notify>,
+  backlog: Arc<AtomicUsize>,
+}
+
+impl ParseHandle {
+  /// Queues a chunk for parsing, blocking while the proc's queue is
+  /// full. Returns false when the scheduler is gone.
+  pub async fn push(&self, chunk: Vec<u8>) -> bool {
+    self.backlog.fetch_add(chunk.len(), Ordering::Relaxed);
+    let len = chunk.len();
+    if self.tx.send(chunk).await.is_err() {
+      self.backlog.fetch_sub(len, Ordering::Relaxed);
+      return false;
+    }
+    self.notify.notify_one();
+    true
+  }
+
+  /// Same as [`push`](Self::push) for the blocking windows reader
+  /// thread.
+  pub fn push_blocking(&self, chunk: Vec<u8>) -> bool {
+    self.backlog.fetch_add(chunk.len(), Ordering::Relaxed);
+    let len = chunk.len();
+    if self.tx.blocking_send(chunk).is_err() {
+      self.backlog.fetch_sub(len, Ordering::Relaxed);
+      return false;
+    }
+    self.notify.notify_one();
+    true
+  }
+
+  /// Bytes queued but not yet parsed, shared with the scheduler.
+  pub fn backlog(&self) -> Arc<AtomicUsize> {
+    self.backlog.clone()
+  }
+}
+
+/// One attached proc as the scheduler task sees it.
+struct Source {
+  id: usize,
+  rx: Receiver<Vec<u8>>,
+  vt: VtWrap,
+  screen: ScreenWrap,
+  dirty: Arc<DirtyProcs>,
+  backlog: Arc<AtomicUsize>,
+}
+
+impl Source {
+  /// Parses up to one quantum from the queue. Returns the number of
+  /// bytes parsed and whether the reader is gone and the queue is empty.
+  fn parse_quantum(&mut self) -> (usize, bool) {
+    // Don't touch the parser lock when nothing is queued.
+    let first = match self.rx.try_recv() {
+      Ok(chunk) => chunk,
+      Err(TryRecvError::Empty) => return (0, false),
+      Err(TryRecvError::Disconnected) => return (0, true),
+    };
+
+    let mut parsed = 0;
+    let mut done = false;
+    let mut vt = self.vt.write().unwrap();
+    crate::prof_span!("vt100_process");
+    let mut chunk = first;
+    loop {
+      parsed += chunk.len();
+      self.backlog.fetch_sub(chunk.len(), Ordering::Relaxed);
+      vt.process(&chunk);
+      if parsed >= QUANTUM {
+        break;
+      }
+      chunk = match self.rx.try_recv() {
+        Ok(chunk) => chunk,
+        Err(TryRecvError::Empty) => break,
+        Err(TryRecvError::Disconnected) => {
+          done = true;
+          break;
+        }
+      };
+    }
+
+    // Skip waking the renderer for output that didn't change anything
+    // visible (e.g. queries and mode changes).
+    let damaged = !vt.screen().damage().is_empty();
+    if damaged {
+      Inst::publish_screen(&mut vt, &self.screen);
+    }
+    drop(vt);
+    if damaged {
+      self.dirty.mark(self.id);
+    }
+
+    (parsed, done)
+  }
+}
+
+/// Single parsing task shared by every proc. Created once on the
+/// runtime, like the reaper.
+pub struct ParseScheduler {
+  reg_tx: UnboundedSender<Source>,
+  notify: Arc<Notify>,
+}
+
+impl ParseScheduler {
+  pub fn new() -> Self {
+    let (reg_tx, reg_rx) = unbounded_channel::<Source>();
+    let notify = Arc::new(Notify::new());
+
+    tokio::spawn(Self::run(reg_rx, notify.clone()));
+
+    ParseScheduler { reg_tx, notify }
+  }
+
+  /// Attaches a proc's parser and returns the handle its reader pushes
+  /// chunks through.
+  pub fn attach(
+    &self,
+    id: usize,
+    vt: VtWrap,
+    screen: ScreenWrap,
+    dirty: Arc<DirtyProcs>,
+  ) -> ParseHandle {
+    let (tx, rx) = channel(QUEUE_CHUNKS);
+    let backlog = Arc::new(AtomicUsize::new(0));
+    let _result = self.reg_tx.send(Source {
+      id,
+      rx,
+      vt,
+      screen,
+      dirty,
+      backlog: backlog.clone(),
+    });
+    ParseHandle {
+      tx,
+      notify: self.notify.clone(),
+      backlog,
+    }
+  }
+
+  async fn run(mut reg_rx: UnboundedReceiver<Source>, notify: Arc<Notify>) {
+    let mut sources: Vec<Source> = Vec::new();
+    let mut reg_open = true;
+    loop {
+      while let Ok(source) = reg_rx.try_recv() {
+        sources.push(source);
+      }
+
+      // Armed before the round so a chunk queued while parsing still
+      // wakes the next one.
+      let notified = notify.notified();
+
+      let mut parsed_any = false;
+      let mut i = 0;
+      while i < sources.len() {
+        let (parsed, done) = sources[i].parse_quantum();
+        parsed_any |= parsed > 0;
+        if done {
+          sources.swap_remove(i);
+        } else {
+          i += 1;
+        }
+      }
+
+      if parsed_any {
+        // Every proc got its quantum; let the render loop and input run
+        // before the next round.
+        let _ = tokio::task::yield_now().await;
+      } else if reg_open {
+        tokio::select! {
+          _ = notified => (),
+          source = reg_rx.recv() => match source {
+            Some(source) => sources.push(source),
+            None => reg_open = false,
+          },
+        }
+      } else if sources.is_empty() {
+        break;
+      } else {
+        notified.await;
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+use std::{collections::HashMap, fs, path::Path};
+
+use anyhow::{bail, Result};
+
+use crate::proc::{Proc, ProcState};
+
+/// File magic; the trailing digits are the format version.
+const MAGIC: &[u8; 8] = b"mprocs01";
+
+/// Saves the screen history of every running proc, keyed by proc name,
+/// into a single binary session file (see the `session` config option).
+/// The whole file is built in memory and written with one sequential
+/// write; the per-screen blobs use the compact `vt100` history codec.
+pub fn save(path: &Path, procs: &[Proc]) -> Result<()> {
+  let mut body = Vec::new();
+  let mut count: u32 = 0;
+  for proc in procs {
+    if let ProcState::Some(inst) = &proc.inst {
+      let mut blob = Vec::new();
+      inst.screen().serialize_history(&mut blob);
+      body.extend_from_slice(&(proc.name.len() as u32).to_le_bytes());
+      body.extend_from_slice(proc.name.as_bytes());
+      body.extend_from_slice(&(blob.len() as u32).to_le_bytes());
+      body.extend_from_slice(&blob);
+      count += 1;
+    }
+  }
+
+  let mut out = Vec::with_capacity(MAGIC.len() + 4 + body.len());
+  out.extend_from_slice(MAGIC);
+  out.extend_from_slice(&count.to_le_bytes());
+  out.extend_from_slice(&body);
+  fs::write(path, out)?;
+  Ok(())
+}
+
+/// Loads a session file written by `save`, returning the saved history
+/// blob for each proc name.
+pub fn load(path: &Path) -> Result<HashMap<String, Vec<u8>>> {
+  let bytes = fs::read(path)?;
+  let mut at = 0;
+
+  if take(&bytes, &mut at, MAGIC.len())? != MAGIC {
+    bail!("Not an mprocs session file: {:?}", path);
+  }
+  let count = take_u32(&bytes, &mut at)? as usize;
+  // every record takes at least its two u32 length fields, so a count the
+  // file cannot hold is rejected before it sizes an allocation
+  if count > (bytes.len() - at) / 8 {
+    bail!("Corrupt session file: {:?}", path);
+  }
+
+  let mut screens = HashMap::with_capacity(count);
+  for _ in 0..count {
+    let name_len = take_u32(&bytes, &mut at)? as usize;
+    let name = String::from_utf8(take(&bytes, &mut at, name_len)?.to_vec())?;
+    let blob_len = take_u32(&bytes, &mut at)? as usize;
+    let blob = take(&bytes, &mut at, blob_len)?.to_vec();
+    screens.insert(name, blob);
+  }
+  Ok(screens)
+}
+
+fn take<'a>(bytes: &'a [u8], at: &mut usize, len: usize) -> Result<&'a [u8]> {
+  match bytes.get(*at..*at + len) {
+    Some(slice) => {
+      *at += len;
+      Ok(slice)
+    }
+    None => bail!("Truncated session file"),
+  }
+}
+
+fn take_u32(bytes: &[u8], at: &mut usize) -> Result<u32> {
+  let slice = take(bytes, at, 4)?;
+  Ok(u32::from_le_bytes([slice[0], slice[1], slice[2], slice[3]]))
+}
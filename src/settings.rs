@@ -20,6 +20,7 @@ pub struct Settings {
   pub hide_keymap_window: bool,
   pub mouse_scroll_speed: usize,
   pub proc_list_width: usize,
+  pub render_fps: usize,
 }
 
 impl Default for Settings {
@@ -31,6 +32,7 @@ impl Default for Settings {
       hide_keymap_window: false,
       mouse_scroll_speed: 5,
       proc_list_width: 30,
+      render_fps: 60,
     };
     settings.add_defaults();
     settings
@@ -130,6 +132,10 @@ impl Settings {
       self.proc_list_width = proc_list_width.as_usize()?;
     }
 
+    if let Some(render_fps) = obj.get(&Value::from("render_fps")) {
+      self.render_fps = render_fps.as_usize()?;
+    }
+
     Ok(())
   }
 
@@ -232,6 +238,11 @@ impl Settings {
       AppEvent::CopyModeEnter,
     );
 
+    s.keymap_add_p(
+      Key::new(KeyCode::Char('t'), KeyModifiers::NONE),
+      AppEvent::ToggleStats,
+    );
+
     for i in 0..8 {
       let char = char::from_digit(i + 1, 10).unwrap();
       s.keymap_add_p(
@@ -241,6 +252,12 @@ impl Settings {
     }
 
     s.keymap_add_c(KeyCode::Esc.into(), AppEvent::CopyModeLeave);
+    s.keymap_add_c(KeyCode::Char('/').into(), AppEvent::CopyModeSearch);
+    s.keymap_add_c(KeyCode::Char('n').into(), AppEvent::CopyModeSearchNext);
+    s.keymap_add_c(
+      Key::new(KeyCode::Char('N'), KeyModifiers::SHIFT),
+      AppEvent::CopyModeSearchPrev,
+    );
     s.keymap_add_c(KeyCode::Char('v').into(), AppEvent::CopyModeEnd);
     s.keymap_add_c(KeyCode::Char('c').into(), AppEvent::CopyModeCopy);
     for code in [KeyCode::Up, KeyCode::Char('k')] {
@@ -1,8 +1,11 @@
+use std::collections::HashMap;
+
 use tui_input::Input;
 
 use crate::{
   keymap::KeymapGroup,
-  proc::{CopyMode, Proc},
+  proc::{CopyMode, Proc, ProcState},
+  stats::StatsState,
 };
 
 #[derive(Clone, Copy, Debug, Eq, PartialEq)]
@@ -33,10 +36,19 @@ impl Scope {
 pub struct State {
   pub scope: Scope,
   pub procs: Vec<Proc>,
+  /// Maps proc ids to indices in `procs`, so that update messages resolve
+  /// their proc without scanning the whole list. Kept in sync by
+  /// `add_proc`/`reindex_procs`.
+  pub proc_index: HashMap<usize, usize>,
   pub selected: usize,
+  /// First visible row of the process list. Only moves when the selection
+  /// would leave the visible window (see `update_procs_scroll`).
+  pub procs_scroll: usize,
 
   pub modal: Option<Modal>,
 
+  pub stats: StatsState,
+
   pub quitting: bool,
 }
 
@@ -53,11 +65,47 @@ impl State {
     self.selected = index;
     if let Some(proc) = self.procs.get_mut(index) {
       proc.changed = false;
+      proc.start_if_lazy();
     }
   }
 
   pub fn get_proc_mut(&mut self, id: usize) -> Option<&mut Proc> {
-    self.procs.iter_mut().find(|proc| proc.id == id)
+    let index = *self.proc_index.get(&id)?;
+    self.procs.get_mut(index)
+  }
+
+  pub fn add_proc(&mut self, proc: Proc) {
+    self.proc_index.insert(proc.id, self.procs.len());
+    self.procs.push(proc);
+  }
+
+  /// Rebuilds the id→index map. Must be called after adding or removing
+  /// procs other than via `add_proc`.
+  pub fn reindex_procs(&mut self) {
+    self.proc_index = self
+      .procs
+      .iter()
+      .enumerate()
+      .map(|(index, proc)| (proc.id, index))
+      .collect();
+  }
+
+  /// Clamps the scroll offset of the process list so the selection stays
+  /// within the `height` visible rows, and returns it. The offset doesn't
+  /// move otherwise, so the list stays put while procs update.
+  pub fn update_procs_scroll(&mut self, height: usize) -> usize {
+    let mut scroll = self
+      .procs_scroll
+      .min(self.procs.len().saturating_sub(height));
+    if height > 0 {
+      if self.selected < scroll {
+        scroll = self.selected;
+      } else if self.selected >= scroll + height {
+        scroll = self.selected + 1 - height;
+      }
+    }
+    self.procs_scroll = scroll;
+    scroll
   }
 
   pub fn get_keymap_group(&self) -> KeymapGroup {
@@ -74,12 +122,16 @@ impl State {
   }
 
   pub fn all_procs_down(&self) -> bool {
-    self.procs.iter().all(|proc| !proc.is_up())
+    self
+      .procs
+      .iter()
+      .all(|proc| !proc.is_up() && !matches!(proc.inst, ProcState::Starting))
   }
 }
 
 pub enum Modal {
   AddProc { input: Input },
   RemoveProc { id: usize },
+  CopySearch { input: Input },
   Quit,
 }
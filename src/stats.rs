@@ -0,0 +1,114 @@
+use std::{
+  sync::atomic::{AtomicU64, AtomicUsize, Ordering},
+  sync::Mutex,
+  time::{Duration, Instant},
+};
+
+/// Number of updates currently sitting in the proc update channel, plus a
+/// running total. Bumped on every send and dropped on every receive.
+/// Always on: the cost at the hot paths is one relaxed atomic op at each
+/// end, whether or not the stats pane is open.
+static UPD_QUEUE: AtomicUsize = AtomicUsize::new(0);
+static UPD_TOTAL: AtomicU64 = AtomicU64::new(0);
+
+pub fn upd_sent() {
+  UPD_QUEUE.fetch_add(1, Ordering::Relaxed);
+  UPD_TOTAL.fetch_add(1, Ordering::Relaxed);
+}
+
+pub fn upd_received() {
+  UPD_QUEUE.fetch_sub(1, Ordering::Relaxed);
+}
+
+pub fn upd_queue() -> usize {
+  UPD_QUEUE.load(Ordering::Relaxed)
+}
+
+pub fn upd_total() -> u64 {
+  UPD_TOTAL.load(Ordering::Relaxed)
+}
+
+/// Smoothing window of the output meters: the rate decays by a factor of
+/// `e` over this span, so a burst fades out in a few seconds instead of
+/// sticking.
+const RATE_TAU: f64 = 2.0;
+
+/// Exponentially decayed bytes/sec meter.
+///
+/// `add` is called by the pty readers, one short mutex lock per chunk.
+/// Readers of the rate get the value decayed to the present, so a proc
+/// that stops streaming fades to zero without anyone ticking the meter.
+pub struct RateMeter {
+  inner: Mutex<RateInner>,
+}
+
+struct RateInner {
+  rate: f64,
+  at: Instant,
+}
+
+impl RateMeter {
+  pub fn new() -> Self {
+    RateMeter {
+      inner: Mutex::new(RateInner {
+        rate: 0.0,
+        at: Instant::now(),
+      }),
+    }
+  }
+
+  pub fn add(&self, bytes: usize) {
+    let mut inner = self.inner.lock().unwrap();
+    Self::decay(&mut inner);
+    // An impulse of `bytes / RATE_TAU` integrates back to `bytes`, so a
+    // steady stream converges on its true byte rate.
+    inner.rate += bytes as f64 / RATE_TAU;
+  }
+
+  /// Current rate in bytes/sec.
+  pub fn rate(&self) -> u64 {
+    let mut inner = self.inner.lock().unwrap();
+    Self::decay(&mut inner);
+    inner.rate as u64
+  }
+
+  fn decay(inner: &mut RateInner) {
+    let now = Instant::now();
+    let dt = now.duration_since(inner.at).as_secs_f64();
+    inner.rate *= (-dt / RATE_TAU).exp();
+    inner.at = now;
+  }
+}
+
+/// State for the stats pane: frame time tracking. Per-proc rates come
+/// straight from the procs' meters at render time.
+pub struct StatsState {
+  pub show: bool,
+  pub frame_last: Duration,
+  pub frame_avg: Duration,
+}
+
+impl StatsState {
+  pub fn new() -> Self {
+    Self {
+      show: false,
+      frame_last: Duration::ZERO,
+      frame_avg: Duration::ZERO,
+    }
+  }
+
+  pub fn record_frame(&mut self, dur: Duration) {
+    self.frame_last = dur;
+    // exponential moving average, so spikes decay instead of sticking
+    self.frame_avg = (self.frame_avg * 7 + dur) / 8;
+  }
+
+  /// Height of the stats pane (including borders), or 0 when hidden.
+  pub fn height(&self, procs: usize) -> u16 {
+    if self.show {
+      (4 + procs).min(12) as u16
+    } else {
+      0
+    }
+  }
+}
@@ -0,0 +1,186 @@
+use std::io::{self, Write};
+use std::sync::{Arc, Mutex};
+
+use tokio::sync::mpsc::UnboundedSender;
+use tui::backend::CrosstermBackend;
+use tui::layout::Rect;
+
+/// Begin/end synchronized update (DEC private mode 2026). Terminals that
+/// support it paint the whole frame atomically; others ignore the
+/// sequences.
+const BSU: &[u8] = b"\x1b[?2026h";
+const ESU: &[u8] = b"\x1b[?2026l";
+
+/// Where the frames of an attached client go. The daemon swaps the sender
+/// in when a client attaches and clears it when the client hangs up;
+/// frames drawn while no client is attached are dropped.
+pub type ClientSink = Arc<Mutex<Option<UnboundedSender<Vec<u8>>>>>;
+
+/// Destination of the rendered frames: the local terminal, or the
+/// currently attached client of a daemon.
+pub enum TermOut {
+  Stdout(io::Stdout),
+  Client(ClientSink),
+}
+
+impl Write for TermOut {
+  fn write(&mut self, bytes: &[u8]) -> io::Result<usize> {
+    match self {
+      TermOut::Stdout(stdout) => stdout.write(bytes),
+      TermOut::Client(sink) => {
+        if let Some(sink) = &*sink.lock().unwrap() {
+          let _result = sink.send(bytes.to_vec());
+        }
+        Ok(bytes.len())
+      }
+    }
+  }
+
+  fn flush(&mut self) -> io::Result<()> {
+    match self {
+      TermOut::Stdout(stdout) => stdout.flush(),
+      TermOut::Client(_) => Ok(()),
+    }
+  }
+}
+
+/// The terminal backend used throughout the ui: crossterm drawing through
+/// the frame buffer into a [`TermOut`].
+///
+/// In daemon mode there is no local terminal to query, so the size comes
+/// from a shared value updated by the attach protocol instead of from
+/// crossterm.
+pub struct Backend {
+  inner: CrosstermBackend<TermBuf<TermOut>>,
+  size: Option<Arc<Mutex<(u16, u16)>>>,
+}
+
+impl Backend {
+  pub fn stdout() -> Self {
+    Backend {
+      inner: CrosstermBackend::new(TermBuf::new(TermOut::Stdout(io::stdout()))),
+      size: None,
+    }
+  }
+
+  pub fn client(sink: ClientSink, size: Arc<Mutex<(u16, u16)>>) -> Self {
+    Backend {
+      inner: CrosstermBackend::new(TermBuf::new(TermOut::Client(sink))),
+      size: Some(size),
+    }
+  }
+}
+
+impl tui::backend::Backend for Backend {
+  fn draw<'a, I>(&mut self, content: I) -> io::Result<()>
+  where
+    I: Iterator<Item = (u16, u16, &'a tui::buffer::Cell)>,
+  {
+    self.inner.draw(content)
+  }
+
+  fn hide_cursor(&mut self) -> io::Result<()> {
+    self.inner.hide_cursor()
+  }
+
+  fn show_cursor(&mut self) -> io::Result<()> {
+    self.inner.show_cursor()
+  }
+
+  fn get_cursor(&mut self) -> io::Result<(u16, u16)> {
+    match &self.size {
+      // There is no local terminal to ask.
+      Some(_) => Ok((0, 0)),
+      None => self.inner.get_cursor(),
+    }
+  }
+
+  fn set_cursor(&mut self, x: u16, y: u16) -> io::Result<()> {
+    self.inner.set_cursor(x, y)
+  }
+
+  fn clear(&mut self) -> io::Result<()> {
+    self.inner.clear()
+  }
+
+  fn size(&self) -> io::Result<Rect> {
+    match &self.size {
+      Some(size) => {
+        let (width, height) = *size.lock().unwrap();
+        Ok(Rect::new(0, 0, width, height))
+      }
+      None => self.inner.size(),
+    }
+  }
+
+  fn flush(&mut self) -> io::Result<()> {
+    tui::backend::Backend::flush(&mut self.inner)
+  }
+}
+
+/// Buffered writer for the terminal backend.
+///
+/// The backend emits many small writes per frame (cursor moves, style
+/// changes, cell runs); straight to stdout each one is a syscall, which
+/// hurts over high-latency connections. `TermBuf` collects a whole frame
+/// in a reusable buffer, frames it with synchronized-update escapes, and
+/// hands it to the inner writer as a single write on flush.
+pub struct TermBuf<W: Write> {
+  out: W,
+  buf: Vec<u8>,
+}
+
+impl<W: Write> TermBuf<W> {
+  pub fn new(out: W) -> Self {
+    TermBuf {
+      out,
+      buf: Vec::with_capacity(64 * 1024),
+    }
+  }
+}
+
+impl<W: Write> Write for TermBuf<W> {
+  fn write(&mut self, bytes: &[u8]) -> io::Result<usize> {
+    if self.buf.is_empty() {
+      self.buf.extend_from_slice(BSU);
+    }
+    self.buf.extend_from_slice(bytes);
+    Ok(bytes.len())
+  }
+
+  fn flush(&mut self) -> io::Result<()> {
+    if self.buf.is_empty() {
+      return Ok(());
+    }
+    self.buf.extend_from_slice(ESU);
+    let result = self
+      .out
+      .write_all(&self.buf)
+      .and_then(|()| self.out.flush());
+    self.buf.clear();
+    result
+  }
+}
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+
+  #[test]
+  fn frames_are_single_writes() {
+    let mut term = TermBuf::new(Vec::new());
+    term.write_all(b"\x1b[1;1Hhello").unwrap();
+    term.write_all(b" world").unwrap();
+    assert_eq!(term.out, b"");
+    term.flush().unwrap();
+    assert_eq!(
+      term.out,
+      b"\x1b[?2026h\x1b[1;1Hhello world\x1b[?2026l".to_vec()
+    );
+
+    // An empty flush writes nothing at all.
+    let len = term.out.len();
+    term.flush().unwrap();
+    assert_eq!(term.out.len(), len);
+  }
+}
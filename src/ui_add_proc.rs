@@ -1,7 +1,4 @@
-use std::io;
-
 use tui::{
-  backend::CrosstermBackend,
   layout::Rect,
   text::Span,
   widgets::{Clear, Paragraph},
@@ -9,10 +6,9 @@ use tui::{
 };
 use tui_input::Input;
 
+use crate::term_buf::Backend;
 use crate::theme::Theme;
 
-type Backend = CrosstermBackend<io::Stdout>;
-
 pub fn render_add_proc(
   area: Rect,
   frame: &mut Frame<Backend>,
@@ -1,7 +1,4 @@
-use std::io;
-
 use tui::{
-  backend::CrosstermBackend,
   layout::{Margin, Rect},
   style::{Color, Style},
   text::{Span, Spans, Text},
@@ -14,11 +11,10 @@ use crate::{
   event::AppEvent,
   keymap::{Keymap, KeymapGroup},
   state::State,
+  term_buf::Backend,
   theme::Theme,
 };
 
-type Backend = CrosstermBackend<io::Stdout>;
-
 pub fn render_keymap(
   area: Rect,
   frame: &mut Frame<Backend>,
@@ -1,7 +1,4 @@
-use std::io;
-
 use tui::{
-  backend::CrosstermBackend,
   layout::{Margin, Rect},
   style::{Color, Modifier, Style},
   text::{Span, Spans},
@@ -10,12 +7,16 @@ use tui::{
 };
 
 use crate::{
-  proc::Proc,
+  proc::{Proc, ProcState},
   state::{Scope, State},
+  term_buf::Backend,
   theme::Theme,
+  ui_stats::format_bytes,
 };
 
-type Backend = CrosstermBackend<io::Stdout>;
+/// Output rates below this are not worth a column in the list; a shell
+/// echoing a prompt should not look like a hot proc.
+const RATE_SHOW_MIN: u64 = 1024;
 
 pub fn render_procs(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
   if area.width <= 2 {
@@ -27,14 +28,20 @@ pub fn render_procs(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
 
   let active = state.scope == Scope::Procs;
 
+  // Only the visible window of procs is turned into list items, so the
+  // per-frame cost doesn't grow with the total number of procs.
+  let height = area.height.saturating_sub(2) as usize;
+  let scroll = state.update_procs_scroll(height);
+  let selected = state.selected;
+  let last = (scroll + height).min(state.procs.len());
+
   let mut list_state = ListState::default();
-  list_state.select(Some(state.selected));
-  let items = state
-    .procs
+  list_state.select(selected.checked_sub(scroll).filter(|i| *i < height));
+  let items = state.procs[scroll..last]
     .iter_mut()
     .enumerate()
     .map(|(i, proc)| {
-      create_proc_item(proc, i == state.selected, area.width - 2, theme)
+      create_proc_item(proc, scroll + i == selected, area.width - 2, theme)
     })
     .collect::<Vec<_>>();
 
@@ -82,9 +89,25 @@ fn create_proc_item<'a>(
     Span::raw(" ")
   };
 
+  // Current output rate, shown while a proc is streaming so the hot
+  // ones stand out in the list.
+  let rate = match &proc.inst {
+    ProcState::Some(inst) => inst.rate(),
+    _ => 0,
+  };
+  let rate = if rate >= RATE_SHOW_MIN {
+    Span::styled(
+      format!("{}/s ", format_bytes(rate)),
+      Style::default().fg(Color::Yellow),
+    )
+  } else {
+    Span::raw("")
+  };
+
   let mut name = proc.name.clone();
   let name_max = (width as usize)
     .saturating_sub(mark.width())
+    .saturating_sub(rate.width())
     .saturating_sub(status.width());
   let name_len = name.chars().count();
   if name_len > name_max {
@@ -109,7 +132,7 @@ fn create_proc_item<'a>(
   };
   let name = Span::styled(name, name_style);
 
-  ListItem::new(Spans::from(vec![mark, name, status]))
+  ListItem::new(Spans::from(vec![mark, name, rate, status]))
     .style(theme.get_procs_item(is_cur))
 }
 
@@ -124,11 +147,9 @@ pub fn procs_get_clicked_index(
     horizontal: 1,
   });
   if procs_check_hit(area, x, y) {
-    let index = y - inner.y;
-    let scroll = (state.selected + 1).saturating_sub(inner.height as usize);
-    let index = index as usize + scroll;
+    let index = (y - inner.y) as usize + state.procs_scroll;
     if index < state.procs.len() {
-      return Some(index as usize);
+      return Some(index);
     }
   }
   None
@@ -1,16 +1,12 @@
-use std::io;
-
 use tui::{
-  backend::CrosstermBackend,
   layout::Rect,
   widgets::{Clear, Paragraph},
   Frame,
 };
 
+use crate::term_buf::Backend;
 use crate::theme::Theme;
 
-type Backend = CrosstermBackend<io::Stdout>;
-
 pub fn render_remove_proc(area: Rect, frame: &mut Frame<Backend>) {
   let theme = Theme::default();
 
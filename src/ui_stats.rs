@@ -0,0 +1,80 @@
+use tui::{
+  layout::{Margin, Rect},
+  style::{Color, Style},
+  text::{Span, Spans, Text},
+  widgets::{Clear, Paragraph},
+  Frame,
+};
+
+use crate::proc::ProcState;
+use crate::term_buf::Backend;
+use crate::{state::State, stats, theme::Theme};
+
+pub fn render_stats(area: Rect, frame: &mut Frame<Backend>, state: &State) {
+  if area.height < 3 {
+    return;
+  }
+
+  let theme = Theme::default();
+
+  let block = theme
+    .pane(false)
+    .title(Span::styled("Stats", theme.pane_title(false)));
+  frame.render_widget(Clear, area);
+  frame.render_widget(block, area);
+
+  let label = Style::default().fg(Color::Yellow);
+  let mut lines = vec![
+    Spans::from(vec![
+      Span::styled("frame: ", label),
+      Span::raw(format!(
+        "{:.1}ms (avg {:.1}ms)",
+        state.stats.frame_last.as_secs_f64() * 1000.0,
+        state.stats.frame_avg.as_secs_f64() * 1000.0,
+      )),
+    ]),
+    Spans::from(vec![
+      Span::styled("updates: ", label),
+      Span::raw(format!(
+        "{} queued, {} total",
+        stats::upd_queue(),
+        stats::upd_total(),
+      )),
+    ]),
+  ];
+  for proc in &state.procs {
+    // Bytes waiting in the proc's parse queue: a non-zero value here
+    // means this proc is outrunning its fair share of the parser.
+    let (rate, backlog) = match &proc.inst {
+      ProcState::Some(inst) => (inst.rate(), inst.backlog()),
+      _ => (0, 0),
+    };
+    lines.push(Spans::from(vec![
+      Span::styled(format!("{}: ", proc.name), label),
+      Span::raw(format!(
+        "{}/s, {} queued",
+        format_bytes(rate),
+        format_bytes(backlog as u64),
+      )),
+    ]));
+  }
+
+  let p = Paragraph::new(Text::from(lines));
+  frame.render_widget(
+    p,
+    area.inner(&Margin {
+      vertical: 1,
+      horizontal: 1,
+    }),
+  );
+}
+
+pub fn format_bytes(bytes: u64) -> String {
+  if bytes >= 1024 * 1024 {
+    format!("{:.1}MB", bytes as f64 / (1024.0 * 1024.0))
+  } else if bytes >= 1024 {
+    format!("{:.1}KB", bytes as f64 / 1024.0)
+  } else {
+    format!("{}B", bytes)
+  }
+}
@@ -1,7 +1,4 @@
-use std::io;
-
 use tui::{
-  backend::CrosstermBackend,
   layout::{Margin, Rect},
   style::{Color, Modifier, Style},
   text::{Span, Spans, Text},
@@ -10,13 +7,12 @@ use tui::{
 };
 
 use crate::{
-  proc::{CopyMode, Pos, ProcState},
+  proc::{CopyMode, CopySearch, Pos, ProcState},
   state::{Scope, State},
+  term_buf::Backend,
   theme::Theme,
 };
 
-type Backend = CrosstermBackend<io::Stdout>;
-
 pub fn render_term(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
   if area.width < 3 || area.height < 3 {
     return;
@@ -46,11 +42,22 @@ pub fn render_term(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
 
     match &proc.inst {
       ProcState::None => (),
+      ProcState::Starting => {
+        let text =
+          Text::styled("Starting...", Style::default().fg(Color::Gray));
+        frame.render_widget(
+          Paragraph::new(text),
+          area.inner(&Margin {
+            vertical: 1,
+            horizontal: 1,
+          }),
+        );
+      }
       ProcState::Some(inst) => {
-        let vt = inst.vt.read().unwrap();
+        let snapshot = inst.screen();
         let (screen, cursor) = match &proc.copy_mode {
           CopyMode::None(_) => {
-            let screen = vt.screen();
+            let screen = &*snapshot;
             let cursor = if screen.hide_cursor() {
               None
             } else {
@@ -70,7 +77,8 @@ pub fn render_term(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
           }
         };
 
-        let term = UiTerm::new(screen, &proc.copy_mode);
+        let term =
+          UiTerm::new(screen, &proc.copy_mode, proc.copy_search.as_ref());
         frame.render_widget(
           term,
           area.inner(&Margin {
@@ -102,71 +110,135 @@ pub fn render_term(area: Rect, frame: &mut Frame<Backend>, state: &mut State) {
 pub struct UiTerm<'a> {
   screen: &'a vt100::Screen,
   copy_mode: &'a CopyMode,
+  search: Option<&'a CopySearch>,
 }
 
 impl<'a> UiTerm<'a> {
-  pub fn new(screen: &'a vt100::Screen, copy_mode: &'a CopyMode) -> Self {
-    UiTerm { screen, copy_mode }
+  pub fn new(
+    screen: &'a vt100::Screen,
+    copy_mode: &'a CopyMode,
+    search: Option<&'a CopySearch>,
+  ) -> Self {
+    UiTerm {
+      screen,
+      copy_mode,
+      search,
+    }
   }
 }
 
 impl Widget for UiTerm<'_> {
   fn render(self, area: Rect, buf: &mut tui::buffer::Buffer) {
+    crate::prof_span!("ui_term_render");
     let screen = self.screen;
+    let (_, cols) = screen.size();
+    let scrollback = screen.scrollback();
 
+    // The iterator resolves the scrollback offset once for the whole
+    // frame instead of once per row.
+    let mut visible_rows = screen.visible_rows(0..area.height);
     for row in 0..area.height {
-      for col in 0..area.width {
-        let to_cell = buf.get_mut(area.x + col, area.y + row);
-        if let Some(cell) = screen.cell(row, col) {
-          if cell.has_contents() {
-            let mut mods = Modifier::empty();
-            mods.set(Modifier::BOLD, cell.bold());
-            mods.set(Modifier::ITALIC, cell.italic());
-            mods.set(Modifier::REVERSED, cell.inverse());
-            mods.set(Modifier::UNDERLINED, cell.underline());
-
-            let copy_mode = match self.copy_mode {
-              CopyMode::None(_) => None,
-              CopyMode::Start(_, start) => Some((start, start)),
-              CopyMode::Range(_, start, end) => Some((start, end)),
-            };
-            let (fg, bg) = match copy_mode {
-              Some((start, end))
-                if Pos::within(
-                  start,
-                  end,
-                  &Pos {
-                    y: (row as i32) - screen.scrollback() as i32,
-                    x: col as i32,
-                  },
-                ) =>
-              {
-                (Some(Color::Black), Some(Color::Cyan))
-              }
-              _ => (conv_color(cell.fgcolor()), conv_color(cell.bgcolor())),
-            };
+      let y = area.y + row;
+      if let Some(runs) = visible_rows.next().map(vt100::Row::styled_runs) {
+        // Cells that are not covered by any run stay at the buffer default
+        // (a blank cell), which is what the per-cell loop used to produce
+        // for them.
+        for run in runs.iter() {
+          if run.start() >= area.width {
+            break;
+          }
+          let mut mods = Modifier::empty();
+          mods.set(Modifier::BOLD, run.bold());
+          mods.set(Modifier::ITALIC, run.italic());
+          mods.set(Modifier::REVERSED, run.inverse());
+          mods.set(Modifier::UNDERLINED, run.underline());
+          let style = Style {
+            fg: conv_color(run.fgcolor()),
+            bg: conv_color(run.bgcolor()),
+            add_modifier: mods,
+            sub_modifier: Modifier::empty(),
+          };
+          buf.set_stringn(
+            area.x + run.start(),
+            y,
+            run.text(),
+            (area.width - run.start()) as usize,
+            style,
+          );
+        }
+        for col in cols.min(area.width)..area.width {
+          // Out of bounds.
+          buf.get_mut(area.x + col, y).set_char('?');
+        }
+      } else {
+        // Out of bounds.
+        for col in 0..area.width {
+          buf.get_mut(area.x + col, y).set_char('?');
+        }
+      }
+    }
 
-            let style = Style {
-              fg,
-              bg,
-              add_modifier: mods,
-              sub_modifier: Modifier::empty(),
-            };
-            to_cell.set_style(style);
+    // The copy mode selection covers a contiguous range of columns on every
+    // row it touches, so it is applied per row range instead of being
+    // tested for every cell.
+    let copy_mode = match self.copy_mode {
+      CopyMode::None(_) => None,
+      CopyMode::Start(_, start) => Some((start, start)),
+      CopyMode::Range(_, start, end) => Some((start, end)),
+    };
+    if let Some((start, end)) = copy_mode {
+      let (low, high) = Pos::to_low_high(start, end);
+      for (row, line) in screen.visible_rows(0..area.height).enumerate() {
+        let y = row as i32 - scrollback as i32;
+        if y < low.y {
+          continue;
+        }
+        if y > high.y {
+          break;
+        }
+        let x0 = if y == low.y { low.x.max(0) as u16 } else { 0 };
+        let x1 = if y == high.y {
+          high.x.min(area.width as i32 - 1)
+        } else {
+          area.width as i32 - 1
+        };
+        if (x1 as i64) < x0 as i64 {
+          continue;
+        }
+        overlay_row(line, buf, area, row as u16, x0, x1 as u16, Color::Cyan);
+      }
+    }
 
-            to_cell.set_symbol(&cell.contents());
+    // Search matches are sorted by position, so only the visible slice is
+    // visited. Matches are painted after the selection so that they show
+    // through it, like the per-cell precedence used to work.
+    if let Some(search) = self.search {
+      if search.len > 0 {
+        for (i, m) in search.matches.iter().enumerate() {
+          let row = m.y + scrollback as i32;
+          if row < 0 {
+            continue;
+          }
+          if row >= area.height as i32 {
+            break;
+          }
+          let x0 = m.x.max(0) as u16;
+          let x1 = (m.x + search.len as i32 - 1).min(area.width as i32 - 1);
+          if (x1 as i64) < x0 as i64 {
+            continue;
+          }
+          let bg = if i == search.current {
+            Color::LightGreen
           } else {
-            // Cell doesn't have content.
-            to_cell.set_char(' ');
+            Color::Yellow
+          };
+          let row = row as u16;
+          if let Some(line) = screen.visible_rows(row..row + 1).next() {
+            overlay_row(line, buf, area, row, x0, x1 as u16, bg);
           }
-        } else {
-          // Out of bounds.
-          to_cell.set_char('?');
         }
       }
     }
-
-    let scrollback = screen.scrollback();
     if scrollback > 0 {
       let str = format!(" -{} ", scrollback);
       let width = str.len() as u16;
@@ -181,6 +253,31 @@ impl Widget for UiTerm<'_> {
   }
 }
 
+/// Paints an overlay background over `x0..=x1` of a visible row. Only cells
+/// with contents are painted, keeping blank cells unhighlighted.
+fn overlay_row(
+  line: &vt100::Row,
+  buf: &mut tui::buffer::Buffer,
+  area: Rect,
+  row: u16,
+  x0: u16,
+  x1: u16,
+  bg: Color,
+) {
+  let style = Style::default().fg(Color::Black).bg(bg);
+  let cells = line.cells();
+  for col in x0..=x1 {
+    if col >= area.width {
+      break;
+    }
+    if let Some(cell) = cells.get(usize::from(col)) {
+      if cell.has_contents() {
+        buf.get_mut(area.x + col, area.y + row).set_style(style);
+      }
+    }
+  }
+}
+
 fn conv_color(color: vt100::Color) -> Option<tui::style::Color> {
   match color {
     vt100::Color::Default => None,
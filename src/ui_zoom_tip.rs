@@ -1,18 +1,12 @@
-use std::io;
-
-use tui::{
-  backend::CrosstermBackend, layout::Rect, text::Text, widgets::Paragraph,
-  Frame,
-};
+use tui::{layout::Rect, text::Text, widgets::Paragraph, Frame};
 
 use crate::{
   event::AppEvent,
   keymap::{Keymap, KeymapGroup},
+  term_buf::Backend,
   theme::Theme,
 };
 
-type Backend = CrosstermBackend<io::Stdout>;
-
 pub fn render_zoom_tip(
   area: Rect,
   frame: &mut Frame<Backend>,